@@ -3,9 +3,8 @@ import os
 import glob
 import subprocess
 import pygraphviz as pgv
-import mysql.connector
 from apply_directives import apply_directives
-from sklearn.preprocessing import OneHotEncoder
+from db4hls import Results
 import re
 from tqdm import tqdm
 import multiprocessing
@@ -14,6 +13,7 @@ import config
 from math import ceil, floor, log2, log10
 import numpy as np
 import time
+import hashlib
 
 
 import torch
@@ -21,12 +21,38 @@ import torch_geometric as geo
 from torch_geometric.data import Dataset, Data
 from multiprocessing import Process, Manager
 
-from dataset_gpu import CustomData
+from dataset_gpu import CustomData, shardFile, openShard, loadSample
+
+# in-process graph compiler, built with `make python` in graph_compiler
+try:
+    import graph_compiler_py
+except ImportError:
+    graph_compiler_py = None
+
+# kernels parsed by the binding, one per kernel per process
+boundKernels = {}
 
 
 def formatForEncoder(input):
     return np.array(list(input)).reshape(-1, 1)
 
+def openShardArray(saveDir, k, name, dtype, shape):
+    return np.lib.format.open_memmap(shardFile(saveDir, k, name), mode='w+', dtype=dtype, shape=tuple(int(d) for d in shape))
+
+def oneHotColumn(column, categories, out, offset):
+    # categories are sorted, the same order sklearn's OneHotEncoder gave them
+    indices = np.searchsorted(categories, column)
+    indices = np.minimum(indices, len(categories) - 1)
+    unknown = categories[indices] != column
+    if unknown.any():
+        raise ValueError(f"Found unknown categories {set(column[unknown])} during encoding")
+
+    out[np.arange(len(column)), offset + indices] = 1
+    return offset + len(categories)
+
+def graphIntList(graph, name):
+    return np.array(graph.graph_attr[name].split(), dtype=np.int64)
+
 def tuplesToCOO(tuples, biEdges):
     sources, destinations = zip(*tuples)
     pattern = re.compile(r'\d+$')
@@ -61,6 +87,8 @@ class CustomDataset(Dataset):
 
         self.parseConfig()
 
+        self.results = Results()
+
         self.kernels = {'gemm' : 297}
 
         kernelMap = {   "gemm" : 297,
@@ -119,12 +147,19 @@ class CustomDataset(Dataset):
   
 
         self.index = 0
+        self.samples = []
+        self.graphDir = "temp/graphs/"
+        # per config, so configs built side by side or one after another don't overwrite each other's graphs
+        self.encodedDir = "temp/encoded/" + self.config_name + "/"
+        self.openShards = {}
+        self.kernelMeta = {}
+        self.pragmas = []
 
         super().__init__()
 
     @property
     def processed_file_names(self):
-        return glob.glob(f"{self.saveDir}*.pt")
+        return glob.glob(f"{self.saveDir}shard_*.npy")
     
     def parseConfig(self):
         self.one_hot_node_encoders = []
@@ -134,6 +169,9 @@ class CustomDataset(Dataset):
         self.index_edge_encoders = []
         with open(self.config_file, 'r') as file:
             self.invocation = file.readline().strip()
+            # the compiler gives us the BB graph directly
+            if "--add_bb_graph" not in self.invocation.split():
+                self.invocation += " --add_bb_graph"
             for line in file:
                 line = line.strip()
                 words = line.split()
@@ -142,12 +180,8 @@ class CustomDataset(Dataset):
                 if words[0] == "node":
                     # config file format: node dotFileKey one_hot tag1 tag2 ...
                     if words[2] == config.one_hot_encoder_method:
-                        encoder = OneHotEncoder(sparse_output=False, handle_unknown='error')
-                        tags = set()
-                        for word in words[3:]:
-                            tags.add(word)
-                        encoder.fit(formatForEncoder(tags))
-                        self.one_hot_node_encoders.append({"key" :key, "encoder" : encoder})
+                        categories = np.array(sorted(set(words[3:])))
+                        self.one_hot_node_encoders.append({"key" :key, "categories" : categories})
                     # config file format: node dotFileKey normalize max
                     elif words[2] == config.normalize_float_method:
                         max = words[3]
@@ -158,72 +192,32 @@ class CustomDataset(Dataset):
 
                 if words[0] == "edge":
                     if words[2] == config.one_hot_encoder_method:
-                        encoder = OneHotEncoder(sparse_output=False, handle_unknown='error')
-                        tags = set()
-                        for word in words[3:]:
-                            tags.add(word)
-                        encoder.fit(formatForEncoder(tags))
-                        self.one_hot_edge_encoders.append({"key" :key, "encoder" : encoder})
+                        categories = np.array(sorted(set(words[3:])))
+                        self.one_hot_edge_encoders.append({"key" :key, "categories" : categories})
                     if words[2] == config.index_method:
                         tags = list()
                         for word in words[3:]:
                             tags.append(word)
                         self.index_edge_encoders.append({"key":key, "tags":tags})
     def getMaxValues(self):
-        cnx = mysql.connector.connect(user='user', password='password', host='localhost', auth_plugin='mysql_native_password')
-        cursor = cnx.cursor()
-        query = """
-        SELECT 
-        MAX(db4hls.resource_results.hls_lut), 
-        MAX(db4hls.resource_results.hls_ff),
-        MAX(db4hls.resource_results.hls_bram),
-        MAX(db4hls.resource_results.hls_dsp),
-        MAX(db4hls.performance_results.estimated_clock),
-        MAX(db4hls.performance_results.average_latency)
-        FROM db4hls.configuration
-        JOIN db4hls.configuration_space ON db4hls.configuration.id_configuration_space = db4hls.configuration_space.id_configuration_space
-        JOIN db4hls.implementation ON db4hls.configuration.hash_configuration = db4hls.implementation.hash_configuration
-        LEFT JOIN db4hls.resource_results ON db4hls.implementation.id_resource_results = db4hls.resource_results.id_resource_result
-        LEFT JOIN db4hls.performance_results ON db4hls.implementation.id_performance_results = db4hls.performance_results.id_performance_result
-        WHERE db4hls.performance_results.average_latency > 0
-        """
-
-        cursor.execute(query)
-        result = cursor.fetchall()
-
-        self.max_luts = result[0][0]
-        self.max_ffs = result[0][1]
-        self.max_brams = result[0][2]
-        self.max_dsps = result[0][3]
-        self.max_clock = result[0][4]
-        self.max_latency = result[0][5]
+        result = self.results.maxValues()
+
+        self.max_luts = result[0]
+        self.max_ffs = result[1]
+        self.max_brams = result[2]
+        self.max_dsps = result[3]
+        self.max_clock = result[4]
+        self.max_latency = result[5]
 
         self.max_latency_log = log2(self.max_latency) - log2(600)
 
     def list(self):
-        cnx = mysql.connector.connect(user='user', password='password', host='localhost', auth_plugin='mysql_native_password')
-        cursor = cnx.cursor()
-
         for kernelName, id in self.kernels.items():
-            query = f"""
-            SELECT 
-            COUNT(*)
-            FROM db4hls.configuration
-            JOIN db4hls.configuration_space ON db4hls.configuration.id_configuration_space = db4hls.configuration_space.id_configuration_space
-            JOIN db4hls.implementation ON db4hls.configuration.hash_configuration = db4hls.implementation.hash_configuration
-            LEFT JOIN db4hls.resource_results ON db4hls.implementation.id_resource_results = db4hls.resource_results.id_resource_result
-            WHERE db4hls.configuration_space.id_configuration_space = {id}
-            """
-
-            cursor.execute(query)
-            result = cursor.fetchall()
-            print(kernelName, result[0])
+            print(kernelName, self.results.count(id))
 
     def test(self):
         self.getMaxValues()
 
-        cnx = mysql.connector.connect(user='user', password='password', host='localhost', auth_plugin='mysql_native_password')
-        cursor = cnx.cursor()
         for kernelName, id in self.kernels.items():
             print("Testing: ", kernelName)
 
@@ -234,25 +228,7 @@ class CustomDataset(Dataset):
             self.num_bbs[kernelName] = num_bbs
             self.bb_batch[kernelName] = bb_batch
 
-            query = f"""
-            SELECT 
-            db4hls.configuration.config_script, 
-            db4hls.resource_results.hls_lut,
-            db4hls.resource_results.hls_ff,
-            db4hls.resource_results.hls_bram,
-            db4hls.resource_results.hls_dsp,
-            db4hls.performance_results.estimated_clock,
-            db4hls.performance_results.average_latency
-            FROM db4hls.configuration
-            JOIN db4hls.configuration_space ON db4hls.configuration.id_configuration_space = db4hls.configuration_space.id_configuration_space
-            JOIN db4hls.implementation ON db4hls.configuration.hash_configuration = db4hls.implementation.hash_configuration
-            LEFT JOIN db4hls.resource_results ON db4hls.implementation.id_resource_results = db4hls.resource_results.id_resource_result
-            LEFT JOIN db4hls.performance_results ON db4hls.implementation.id_performance_results = db4hls.performance_results.id_performance_result
-            WHERE db4hls.configuration_space.id_configuration_space = {id} AND db4hls.performance_results.average_latency > 0
-            """
-
-            cursor.execute(query)
-            result = cursor.fetchall()
+            result = self.results.configurations(id)
 
             graph = self.processRow(kernelName, 0, 0, result[0], True)
             # print(self.get(0))
@@ -260,101 +236,69 @@ class CustomDataset(Dataset):
             # graph.draw(f"test_pdfs/{self.config_name}_{kernelName}.pdf", prog="dot", format="pdf")
             graph.write(f"test_pdfs/{self.config_name}_{kernelName}.dot")
 
-    def buildCFG(self, kernel):
-        out = "temp/0.cpp"
-        apply_directives(kernel, f"kernels/{kernel}.cpp", "", out)
-        full_invocation = self.invocation + f" --top {kernel} --src {out}"
-        graphOutput = subprocess.run(full_invocation, shell=True, capture_output=True, text=True)
-
-        graph = pgv.AGraph(string=graphOutput.stdout)
-        node_list = graph.nodes()
-        edge_list = graph.edges()
-
-        bb_edge_list = defaultdict(set)
-        node_bb_dict = {}
+    def profileEncoding(self, kernels=("gemm", "md_kernel"), repeats=20):
+        for kernelName in kernels:
+            graph = pgv.AGraph(string=self.compileGraph(kernelName, 0, [""]))
 
-        bb_list = []
-        num_bbs = 0
-        for node in node_list:
-            bbID = int(node.attr["bbID"])
-            node_bb_dict[node] = bbID
-            bb_list.append(bbID)
-            num_bbs = max(num_bbs, bbID + 1)
-        bb_list = torch.tensor(bb_list, dtype=torch.int64)
+            start = time.perf_counter()
+            for _ in range(repeats):
+                self.getNodeArray(graph.nodes())
+                self.getEdgeAttributeArray(graph.edges(), True)
+            end = time.perf_counter()
 
-        for edge in edge_list:
-            if not (edge.attr["flowType"] == "control" or edge.attr["flowType"] == "call"):
-                continue
-                
-            sourceIndex = 0
-            targetIndex = 1
+            perGraph = (end - start) / repeats * 1000
+            print(f"{kernelName}: {len(graph.nodes())} nodes, {len(graph.edges())} edges, {perGraph:.2f} ms to encode")
 
-            if edge.attr["style"] == "dashed":
-                sourceIndex = 1
-                targetIndex = 0
-
-            source_bb = node_bb_dict[edge[sourceIndex]]
-            target_bb = node_bb_dict[edge[targetIndex]]
-            if source_bb != target_bb:
-                bb_edge_list[source_bb].add(target_bb)
-
-
-        output_source_list = np.array([[]])
-        output_target_list = np.array([[]])
-
-        for sourceBB, targetBBs in bb_edge_list.items():
-            for targetBB in targetBBs:
-                output_source_list = np.concatenate([output_source_list, formatForEncoder([sourceBB])], axis=1)
-                output_target_list = np.concatenate([output_target_list, formatForEncoder([targetBB])], axis=1)                
+    def buildCFG(self, kernel):
+        graph = pgv.AGraph(string=self.compileGraph(kernel, 0, [""]))
 
+        num_bbs = int(graph.graph_attr["numBBs"])
+        cfg_edges = np.stack([graphIntList(graph, "cfgSources"), graphIntList(graph, "cfgTargets")])
+        bb_list = torch.from_numpy(graphIntList(graph, "nodeBBs"))
         bb_batch = torch.zeros(num_bbs, dtype=torch.int64)
 
-        output_edge_list = torch.tensor(np.concatenate([output_source_list, output_target_list]), dtype=torch.int64)
-        return output_edge_list, bb_list, num_bbs, bb_batch
+        return torch.from_numpy(cfg_edges), bb_list, num_bbs, bb_batch
 
     def getNodeArray(self, node_list):
-        encoded_node_list = []
-        for node in node_list:
-            temp_array = np.array([[]])
-            for one_hot_encoder in self.one_hot_node_encoders:
-                input = formatForEncoder([node.attr[one_hot_encoder["key"]].replace(" ", "")])
-                one_hot = one_hot_encoder["encoder"].transform(input)
-                temp_array = np.concatenate([temp_array, one_hot], axis=1)
-            for normalize_encoder in self.normalized_node_encoders:
-                input = float(node.attr[normalize_encoder["key"]])
-
-                temp = ((input / float(normalize_encoder["max"])) * 2) - 1
-                temp_array = np.concatenate([temp_array, [[temp]]], axis=1)
-            for normalize_encoder in self.log2_normalized_node_encoders:
-                input = float(node.attr[normalize_encoder["key"]])
-                max = float(normalize_encoder["max"])
-                log_input = log2(input)
-                temp = ((log_input / max) * 2) - 1
-                temp_array = np.concatenate([temp_array, [[temp]]], axis=1)
-            for i in range(240):
-                temp_array = np.concatenate([temp_array, [[0]]], axis=1)
-
-            encoded_node_list.append(temp_array[0])
-        
-        node_array = np.asarray(encoded_node_list, dtype=np.float32)
+        # gather every attribute once, then encode column by column into a preallocated matrix
+        attributes = [node.attr for node in node_list]
+
+        num_features = sum(len(encoder["categories"]) for encoder in self.one_hot_node_encoders)
+        num_features += len(self.normalized_node_encoders) + len(self.log2_normalized_node_encoders)
+        # the last 240 features are left as zeros
+        num_features += 240
+
+        node_array = np.zeros((len(attributes), num_features), dtype=np.float32)
+
+        offset = 0
+        for one_hot_encoder in self.one_hot_node_encoders:
+            column = np.array([attr[one_hot_encoder["key"]].replace(" ", "") for attr in attributes])
+            offset = oneHotColumn(column, one_hot_encoder["categories"], node_array, offset)
+        for normalize_encoder in self.normalized_node_encoders:
+            column = np.array([float(attr[normalize_encoder["key"]]) for attr in attributes])
+            node_array[:, offset] = ((column / float(normalize_encoder["max"])) * 2) - 1
+            offset += 1
+        for normalize_encoder in self.log2_normalized_node_encoders:
+            column = np.array([float(attr[normalize_encoder["key"]]) for attr in attributes])
+            node_array[:, offset] = ((np.log2(column) / float(normalize_encoder["max"])) * 2) - 1
+            offset += 1
+
         node_array = torch.from_numpy(node_array)
 
         return node_array
     
 
     def getEdgeAttributeArray(self, edges, biEdges):
-        encoded_edge_list = []
+        attributes = [edge.attr for edge in edges]
 
-        for edge in edges:
-            temp_array = np.array([[]])
-            for one_hot_encoder in self.one_hot_edge_encoders:
-                input = formatForEncoder([edge.attr[one_hot_encoder["key"]]])
-                one_hot = one_hot_encoder["encoder"].transform(input)
-                temp_array = np.concatenate([temp_array, one_hot], axis=1)
+        num_features = sum(len(encoder["categories"]) for encoder in self.one_hot_edge_encoders)
+        edge_array = np.zeros((len(attributes), num_features), dtype=np.float32)
+
+        offset = 0
+        for one_hot_encoder in self.one_hot_edge_encoders:
+            column = np.array([attr[one_hot_encoder["key"]] for attr in attributes])
+            offset = oneHotColumn(column, one_hot_encoder["categories"], edge_array, offset)
 
-            encoded_edge_list.append(temp_array[0])
-        
-        edge_array = np.asarray(encoded_edge_list, dtype=np.float32)
         if(biEdges):
             edge_array = np.concatenate([edge_array, edge_array])
 
@@ -380,22 +324,27 @@ class CustomDataset(Dataset):
     #     edge_array = torch.tensor(temp_array, dtype=torch.int64)
     #     return edge_array
 
-    def processRow(self, kernel, i, j, row, biEdges, returnGraph=False):
+    def compileGraph(self, kernel, j, row):
+        if graph_compiler_py is not None:
+            if kernel not in boundKernels:
+                args = self.invocation.split()[1:]
+                boundKernels[kernel] = graph_compiler_py.Kernel(f"kernels/{kernel}.cpp", kernel, args)
+            dot = boundKernels[kernel].dot(row[0])
+            if "digraph" not in dot:
+                raise RuntimeError(f"{kernel}: no graph for {row[0]!r}")
+            return dot
+
         pragmadFile = "temp/" + str(j) + ".cpp"
         apply_directives(kernel, f"kernels/{kernel}.cpp", row[0], pragmadFile)
         full_invocation = self.invocation + f" --top {kernel} --src {pragmadFile}"
         graphOutput = subprocess.run(full_invocation, shell=True, capture_output=True, text=True)
+        # a failed compile can still print part of a graph, or nothing, which would hash like any other
+        if graphOutput.returncode != 0 or "digraph" not in graphOutput.stdout:
+            raise RuntimeError(f"{kernel}: graph compiler exited with {graphOutput.returncode} for {row[0]!r}\n"
+                               + graphOutput.stderr.strip())
+        return graphOutput.stdout
 
-
-        graph = pgv.AGraph(string=graphOutput.stdout)
-
-        nodeArray = self.getNodeArray(graph.nodes())
-
-        edgeConnectionArray = tuplesToCOO(graph.edges(), biEdges)
-        edgeConnectionArray = torch.from_numpy(edgeConnectionArray)
-        
-        edgeAttributeArray = self.getEdgeAttributeArray(graph.edges(), biEdges)
-
+    def getLabels(self, row):
         normalized_luts = ((float(row[1]) / self.max_luts) * 2) - 1
         normalized_ffs = ((float(row[2]) / self.max_ffs) * 2) - 1
         if(self.max_brams != 0):
@@ -411,9 +360,9 @@ class CustomDataset(Dataset):
 
         normalized_latency = ( (latency_log / self.max_latency_log) * 2 ) - 1
 
-        y = np.array([[normalized_luts, normalized_ffs, normalized_brams, normalized_dsps, normalized_clock, normalized_latency]], dtype=np.float32)
-        y = torch.from_numpy(y)
+        return [normalized_luts, normalized_ffs, normalized_brams, normalized_dsps, normalized_clock, normalized_latency]
 
+    def getMaxY(self):
         max_y = {}
         max_y["LUTs"] = self.max_luts
         max_y["FFs"] = self.max_ffs
@@ -421,109 +370,123 @@ class CustomDataset(Dataset):
         max_y["DSPs"] = self.max_dsps
         max_y["clock"] = self.max_clock
         max_y["latency"] = self.max_latency
+        return max_y
 
-        bb_list = []
-        for node in graph.nodes():
-            bbID = int(node.attr["bbID"])
-            bb_list.append(bbID)
-
-        bb_list = torch.tensor(bb_list, dtype=torch.int64)
-
-        data = CustomData(x=nodeArray, 
-                    edge_index=edgeConnectionArray, 
-                    edge_attr=edgeAttributeArray, 
-                    y=y, 
-                    max_y=max_y,
-                    kernel=kernel,
-                    pragmas=row[0],
-                    cfg_edge_index= self.cfg_edge_index[kernel],
-                    cfg_select = bb_list,
-                    num_bbs = self.num_bbs[kernel],
-                    bb_batch = self.bb_batch[kernel]
-                    )
-        
-        # data.__inc__ = CustomInc
-        
+    def encodeGraph(self, graph, biEdges):
+        nodeArray = self.getNodeArray(graph.nodes())
+        edgeConnectionArray = tuplesToCOO(graph.edges(), biEdges)
+        edgeAttributeArray = self.getEdgeAttributeArray(graph.edges(), biEdges)
 
-        torch.save(data, osp.join(self.saveDir, f'data_{self.index + i + j}.pt')) 
+        encoded = {}
+        encoded["x"] = nodeArray.numpy()
+        encoded["edge_index"] = edgeConnectionArray
+        encoded["edge_attr"] = edgeAttributeArray.numpy()
+        encoded["cfg_select"] = graphIntList(graph, "nodeBBs")
+        return encoded
+
+    def processRow(self, kernel, i, j, row, biEdges, returnGraph=False):
+        graph = pgv.AGraph(string=self.compileGraph(kernel, j, row))
+        encoded = self.encodeGraph(graph, biEdges)
 
         if returnGraph:
             return graph
-        
-    def processColumn(self, kernel, result, j, num_processes, biEdges, returnGraph=False):
-        for i in range(j, len(result), num_processes):
-            row = result[i]
-            pragmadFile = "temp/" + str(j) + ".cpp"
-            apply_directives(kernel, f"kernels/{kernel}.cpp", row[0], pragmadFile)
-            full_invocation = self.invocation + f" --top {kernel} --src {pragmadFile}"
-            graphOutput = subprocess.run(full_invocation, shell=True, capture_output=True, text=True)
-
-            graph = pgv.AGraph(string=graphOutput.stdout)
-            nodeArray = self.getNodeArray(graph.nodes())
-
-
-            edgeConnectionArray = tuplesToCOO(graph.edges(), biEdges)
-            edgeConnectionArray = torch.from_numpy(edgeConnectionArray)
-            
-            edgeAttributeArray = self.getEdgeAttributeArray(graph.edges(), biEdges)
+        return encoded
 
+    def hashColumn(self, kernel, result, j, num_processes):
+        # the compiler output is deterministic (sequential node ids, fixed print order),
+        # so the dot text itself is the canonical form of the graph
+        hashes = []
+        for i in range(j, len(result), num_processes):
+            # rows whose graph didn't compile are left out of the groups, and so out of the dataset
+            try:
+                dot = self.compileGraph(kernel, j, result[i])
+            except RuntimeError as error:
+                print(error)
+                continue
+            graphHash = hashlib.sha1(dot.encode()).hexdigest()
+            dotFile = osp.join(self.graphDir, graphHash + ".dot")
+            if not osp.exists(dotFile):
+                with open(dotFile + f".{j}", 'w') as file:
+                    file.write(dot)
+                os.replace(dotFile + f".{j}", dotFile)
+            hashes.append((i, graphHash))
+        return hashes
+
+    def processColumn(self, kernel, groups, j, num_processes, biEdges):
+        # encoded graphs are staged in temp and packed into the kernel's shard by the parent
+        sizes = []
+        for g in range(j, len(groups), num_processes):
+            graphHash, rowIndices = groups[g]
+            graph = pgv.AGraph(file=osp.join(self.graphDir, graphHash + ".dot"))
+            encoded = self.encodeGraph(graph, biEdges)
+
+            np.savez(osp.join(self.encodedDir, f"{kernel}_{g}.npz"), **encoded)
+            sizes.append((g, encoded["x"].shape[0], encoded["edge_index"].shape[1]))
+        return sizes
+
+    def packShard(self, k, kernelName, result, groups, sizes):
+        # -1 for the rows with no graph
+        graphOf = np.full(len(result), -1, dtype=np.int64)
+        if not groups:
+            return graphOf
+
+        numNodes = np.zeros(len(groups), dtype=np.int64)
+        numEdges = np.zeros(len(groups), dtype=np.int64)
+        for g, nodes, edges in sizes:
+            numNodes[g] = nodes
+            numEdges[g] = edges
+
+        node_offsets = np.concatenate([[0], np.cumsum(numNodes)])
+        edge_offsets = np.concatenate([[0], np.cumsum(numEdges)])
+
+        shard = {}
+        for g in range(len(groups)):
+            encoded = np.load(osp.join(self.encodedDir, f"{kernelName}_{g}.npz"))
+            if not shard:
+                shard["x"] = openShardArray(self.saveDir, k, "x", np.float32, (node_offsets[-1], encoded["x"].shape[1]))
+                shard["cfg_select"] = openShardArray(self.saveDir, k, "cfg_select", np.int64, (node_offsets[-1],))
+                shard["edge_index"] = openShardArray(self.saveDir, k, "edge_index", np.int64, (2, edge_offsets[-1]))
+                shard["edge_attr"] = openShardArray(self.saveDir, k, "edge_attr", np.float32, (edge_offsets[-1], encoded["edge_attr"].shape[1]))
+
+            nodes = slice(node_offsets[g], node_offsets[g + 1])
+            edges = slice(edge_offsets[g], edge_offsets[g + 1])
+            shard["x"][nodes] = encoded["x"]
+            shard["cfg_select"][nodes] = encoded["cfg_select"]
+            shard["edge_index"][:, edges] = encoded["edge_index"]
+            shard["edge_attr"][edges] = encoded["edge_attr"]
+            os.remove(osp.join(self.encodedDir, f"{kernelName}_{g}.npz"))
+
+        for array in shard.values():
+            array.flush()
+
+        np.save(shardFile(self.saveDir, k, "node_offsets"), node_offsets)
+        np.save(shardFile(self.saveDir, k, "edge_offsets"), edge_offsets)
+
+        # labels stay per design point, indexed by row in the kernel's result
+        y = np.array([self.getLabels(row) for row in result], dtype=np.float32)
+        np.save(shardFile(self.saveDir, k, "y"), y)
+
+        for g, (graphHash, rowIndices) in enumerate(groups):
+            graphOf[rowIndices] = g
+        return graphOf
+
+    def groupDuplicates(self, kernel, result, num_processes):
+        with multiprocessing.Pool(processes=num_processes) as pool:
+            input = [(kernel, result, j, num_processes) for j in range(num_processes)]
+            out = pool.starmap(self.hashColumn, input)
+
+        # keep the first row that produced each graph as the order of the unique graphs
+        hashOf = {}
+        for column in out:
+            for i, graphHash in column:
+                hashOf[i] = graphHash
+
+        groups = {}
+        for i in range(len(result)):
+            if i in hashOf:
+                groups.setdefault(hashOf[i], []).append(i)
+        return list(groups.items())
 
-            normalized_luts = ((float(row[1]) / self.max_luts) * 2) - 1
-            normalized_ffs = ((float(row[2]) / self.max_ffs) * 2) - 1
-            if(self.max_brams != 0):
-                normalized_brams = ((float(row[3]) / self.max_brams) * 2) - 1
-            else:
-                normalized_brams = -1.0
-            normalized_dsps = ((float(row[4]) / self.max_dsps) * 2) - 1
-            normalized_clock = ((float(row[5]) / self.max_clock) * 2) - 1
-
-
-
-            latency = row[6]
-            # -log2(500) scales better on the lower numbers
-            latency_log = log2(latency + 600) - log2(600)
-
-            normalized_latency = ( (latency_log / self.max_latency_log) * 2 ) - 1
-
-            y = np.array([[normalized_luts, normalized_ffs, normalized_brams, normalized_dsps, normalized_clock, normalized_latency]], dtype=np.float32)
-            y = torch.from_numpy(y)
-
-            max_y = {}
-            max_y["LUTs"] = self.max_luts
-            max_y["FFs"] = self.max_ffs
-            max_y["BRAMs"] = self.max_brams
-            max_y["DSPs"] = self.max_dsps
-            max_y["clock"] = self.max_clock
-            max_y["latency"] = self.max_latency
-
-            bb_list = []
-            for node in graph.nodes():
-                bbID = int(node.attr["bbID"])
-                bb_list.append(bbID)
-
-            bb_list = torch.tensor(bb_list, dtype=torch.int64)
-
-            data = CustomData(x=nodeArray, 
-                        edge_index=edgeConnectionArray, 
-                        edge_attr=edgeAttributeArray, 
-                        y=y, 
-                        max_y=max_y,
-                        kernel=kernel,
-                        pragmas=row[0],
-                        cfg_edge_index= self.cfg_edge_index[kernel],
-                        cfg_select = bb_list,
-                        num_bbs = self.num_bbs[kernel],
-                        bb_batch = self.bb_batch[kernel]
-                        )
-            
-            # data.__inc__ = CustomInc
-            
-
-            torch.save(data, osp.join(self.saveDir, f'data_{self.index + i}.pt')) 
-
-        if returnGraph:
-            return graph
-        
     def custom_error_callback(error):
         print(f'Got error: {error}')
 
@@ -533,12 +496,17 @@ class CustomDataset(Dataset):
 
         self.getMaxValues()
 
-        cnx = mysql.connector.connect(user='user', password='password', host='localhost', auth_plugin='mysql_native_password')
-        cursor = cnx.cursor()
-
         num_kernels = 0
+        num_graphs = 0
+        self.samples = []
+        self.pragmas = []
+        self.kernelMeta = {}
+        os.makedirs(self.graphDir, exist_ok=True)
+        os.makedirs(self.encodedDir, exist_ok=True)
 
-        
+        # shards left by an earlier build could be for kernels this one doesn't have
+        for stale in glob.glob(osp.join(self.saveDir, "shard_*.npy")):
+            os.remove(stale)
 
         for k, (kernelName, id) in enumerate(self.kernels.items()):
 
@@ -547,26 +515,7 @@ class CustomDataset(Dataset):
             # if kernelName not in kernelList:
             #     continue
 
-            query = f"""
-            SELECT 
-            db4hls.configuration.config_script, 
-            db4hls.resource_results.hls_lut,
-            db4hls.resource_results.hls_ff,
-            db4hls.resource_results.hls_bram,
-            db4hls.resource_results.hls_dsp,
-            db4hls.performance_results.estimated_clock,
-            db4hls.performance_results.average_latency
-            FROM db4hls.configuration
-            JOIN db4hls.configuration_space ON db4hls.configuration.id_configuration_space = db4hls.configuration_space.id_configuration_space
-            JOIN db4hls.implementation ON db4hls.configuration.hash_configuration = db4hls.implementation.hash_configuration
-            LEFT JOIN db4hls.resource_results ON db4hls.implementation.id_resource_results = db4hls.resource_results.id_resource_result
-            LEFT JOIN db4hls.performance_results ON db4hls.implementation.id_performance_results = db4hls.performance_results.id_performance_result
-            WHERE db4hls.configuration_space.id_configuration_space = {id} AND db4hls.performance_results.average_latency > 0
-            """
-
-            cursor.execute(query)
-        
-            result = cursor.fetchall()
+            result = self.results.configurations(id)
 
             if k > 24:
                 num_kernels = num_kernels + len(result)
@@ -597,9 +546,9 @@ class CustomDataset(Dataset):
             
 
             a = time.time()
+            groups = self.groupDuplicates(kernelName, result, num_processes)
             with multiprocessing.Pool(processes=num_processes) as pool:
-                # input = [(kernelName, i, j, result[i+j], biEdges, valid_results) for j in range(num_processes)]
-                input = [(kernelName, result, j, num_processes, biEdges, False) for j in range(num_processes)]
+                input = [(kernelName, groups, j, num_processes, biEdges) for j in range(num_processes)]
                 out = pool.starmap_async(self.processColumn, input, error_callback=CustomDataset.custom_error_callback)
                 
                 # # Close the pool to prevent any more tasks from being submitted
@@ -607,20 +556,52 @@ class CustomDataset(Dataset):
                 out.wait()
                 # Join the worker processes to clean up resources
                 pool.join()
+            sizes = [size for column in out.get() for size in column]
+            graphOf = self.packShard(k, kernelName, result, groups, sizes)
             b = time.time()
+
+            # per kernel tensors are stored once and referenced by kernel id
+            self.kernelMeta[k] = {
+                "kernel": kernelName,
+                "cfg_edge_index": self.cfg_edge_index[kernelName],
+                "num_bbs": self.num_bbs[kernelName],
+                "bb_batch": self.bb_batch[kernelName],
+            }
+            numFailed = 0
+            for i, row in enumerate(result):
+                if graphOf[i] == -1:
+                    numFailed += 1
+                    continue
+                self.samples.append((k, graphOf[i], i))
+                self.pragmas.append(row[0])
+
+            print(f"{kernelName}: {len(result)} configurations, {len(groups)} unique graphs, {numFailed} failed to compile")
             # print(b-a, " seconds")
-            # print(kernelName, len(result))
             num_kernels = num_kernels + len(result)
+            num_graphs = num_graphs + len(groups)
             self.index = self.index + len(result)
+
+        meta = {
+            "kernels": self.kernelMeta,
+            "samples": np.array(self.samples, dtype=np.int64).reshape(-1, 3),
+            "pragmas": self.pragmas,
+            "max_y": self.getMaxY(),
+        }
+        torch.save(meta, osp.join(self.saveDir, "meta.pt"))
                 
         
         endTime = time.time()
 
-        print(f"Time to save {num_kernels} graphs: " + str((endTime - startTime)))
+        print(f"Time to save {num_kernels} configurations as {num_graphs} graphs: " + str((endTime - startTime)))
 
     def len(self):
-        return len(self.processed_file_names)
+        return len(self.samples)
 
     def get(self, idx):
-        data = torch.load(osp.join(self.saveDir, f'data_{idx}.pt'))
-        return data
\ No newline at end of file
+        k, g, i = self.samples[idx]
+        return loadSample(self.shards(k), self.kernelMeta[k], g, i, self.pragmas[idx], self.getMaxY())
+
+    def shards(self, k):
+        if k not in self.openShards:
+            self.openShards[k] = openShard(self.saveDir, k)
+        return self.openShards[k]
\ No newline at end of file
@@ -1,6 +1,7 @@
 
 import torch
 from torch_geometric.data import Dataset, Data
+import numpy as np
 import os.path as osp
 import glob
 
@@ -21,18 +22,57 @@ class CustomData(Data):
             return 0
         
 
+# Each kernel's graphs are packed into one shard: node and edge arrays concatenated over its unique graphs,
+# with offset tables marking where each graph starts. Labels are per design point.
+SHARD_ARRAYS = ["x", "edge_index", "edge_attr", "cfg_select", "node_offsets", "edge_offsets", "y"]
+
+def shardFile(saveDir, k, name):
+    return osp.join(saveDir, f"shard_{k}_{name}.npy")
+
+def openShard(saveDir, k):
+    return {name : np.load(shardFile(saveDir, k, name), mmap_mode='r') for name in SHARD_ARRAYS}
+
+def loadSample(shard, kernelMeta, g, i, pragmas, max_y):
+    n0, n1 = shard["node_offsets"][g], shard["node_offsets"][g + 1]
+    e0, e1 = shard["edge_offsets"][g], shard["edge_offsets"][g + 1]
+
+    # slicing the memory map only reads this graph's rows
+    data = CustomData(x=torch.from_numpy(np.array(shard["x"][n0:n1])),
+                edge_index=torch.from_numpy(np.array(shard["edge_index"][:, e0:e1])),
+                edge_attr=torch.from_numpy(np.array(shard["edge_attr"][e0:e1])),
+                y=torch.from_numpy(np.array(shard["y"][i:i+1])),
+                max_y=max_y,
+                kernel=kernelMeta["kernel"],
+                pragmas=pragmas,
+                cfg_edge_index=kernelMeta["cfg_edge_index"],
+                cfg_select=torch.from_numpy(np.array(shard["cfg_select"][n0:n1])),
+                num_bbs=kernelMeta["num_bbs"],
+                bb_batch=kernelMeta["bb_batch"]
+                )
+    return data
+
 class CustomDataset(Dataset):
     def __init__(self, config_name):
         self.saveDir = "datasets/" + config_name + "/"
+
+        # the metadata holds numpy arrays, which torch>=2.6 won't unpickle by default
+        meta = torch.load(osp.join(self.saveDir, "meta.pt"), weights_only=False)
+        # (kernel id, graph in the kernel's shard, label row) per design point
+        self.samples = meta["samples"]
+        self.pragmas = meta["pragmas"]
+        self.kernelMeta = meta["kernels"]
+        self.max_y = meta["max_y"]
+
+        self.shards = {k : openShard(self.saveDir, k) for k in self.kernelMeta if osp.exists(shardFile(self.saveDir, k, "x"))}
         super().__init__()
 
     @property
     def processed_file_names(self):
-        return glob.glob(f"{self.saveDir}*.pt")
+        return glob.glob(f"{self.saveDir}shard_*.npy")
     
     def len(self):
-        return len(self.processed_file_names)
+        return len(self.samples)
 
     def get(self, idx):
-        data = torch.load(osp.join(self.saveDir, f'data_{idx}.pt'))
-        return data
\ No newline at end of file
+        k, g, i = self.samples[idx]
+        return loadSample(self.shards[k], self.kernelMeta[k], g, i, self.pragmas[idx], self.max_y)
\ No newline at end of file
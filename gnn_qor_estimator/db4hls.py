@@ -0,0 +1,100 @@
+import sqlite3
+import os
+import os.path as osp
+
+# Local copy of the DB4HLS columns the dataset needs, so datasets can be rebuilt
+# without the MySQL server. Make it once with: python db4hls.py
+snapshot_file = "db4hls.sqlite"
+
+def exportSnapshot(output=snapshot_file):
+    import mysql.connector
+
+    cnx = mysql.connector.connect(user='user', password='password', host='localhost', auth_plugin='mysql_native_password')
+    cursor = cnx.cursor()
+    query = """
+    SELECT 
+    db4hls.configuration_space.id_configuration_space,
+    db4hls.configuration.config_script, 
+    db4hls.resource_results.hls_lut,
+    db4hls.resource_results.hls_ff,
+    db4hls.resource_results.hls_bram,
+    db4hls.resource_results.hls_dsp,
+    db4hls.performance_results.estimated_clock,
+    db4hls.performance_results.average_latency
+    FROM db4hls.configuration
+    JOIN db4hls.configuration_space ON db4hls.configuration.id_configuration_space = db4hls.configuration_space.id_configuration_space
+    JOIN db4hls.implementation ON db4hls.configuration.hash_configuration = db4hls.implementation.hash_configuration
+    LEFT JOIN db4hls.resource_results ON db4hls.implementation.id_resource_results = db4hls.resource_results.id_resource_result
+    LEFT JOIN db4hls.performance_results ON db4hls.implementation.id_performance_results = db4hls.performance_results.id_performance_result
+    ORDER BY
+    db4hls.configuration_space.id_configuration_space,
+    db4hls.configuration.hash_configuration,
+    db4hls.implementation.id_resource_results,
+    db4hls.implementation.id_performance_results
+    """
+    cursor.execute(query)
+    rows = cursor.fetchall()
+    cnx.close()
+
+    tempOutput = output + ".tmp"
+    db = sqlite3.connect(tempOutput)
+    db.execute("DROP TABLE IF EXISTS results")
+    db.execute("""
+    CREATE TABLE results (
+        config_space INTEGER,
+        config_script TEXT,
+        lut REAL,
+        ff REAL,
+        bram REAL,
+        dsp REAL,
+        clock REAL,
+        latency REAL
+    )""")
+    # rows keep the order of the query, which is fixed by its ORDER BY, so rebuilt datasets index the same way
+    db.executemany("INSERT INTO results VALUES (?, ?, ?, ?, ?, ?, ?, ?)", rows)
+    db.execute("CREATE INDEX results_config_space ON results (config_space)")
+    db.commit()
+    db.close()
+
+    os.replace(tempOutput, output)
+    print(f"Exported {len(rows)} configurations to {output}")
+
+
+class Results:
+    def __init__(self, path=snapshot_file):
+        if not osp.exists(path):
+            raise FileNotFoundError(f"{path} not found, export it from MySQL first with: python db4hls.py")
+        # connect per query, the dataset object gets pickled into worker processes
+        self.path = path
+
+    def query(self, query, parameters=()):
+        db = sqlite3.connect(self.path)
+        try:
+            return db.execute(query, parameters).fetchall()
+        finally:
+            db.close()
+
+    # MAX of each label over every implementation with a valid latency
+    def maxValues(self):
+        query = """
+        SELECT MAX(lut), MAX(ff), MAX(bram), MAX(dsp), MAX(clock), MAX(latency)
+        FROM results WHERE latency > 0
+        """
+        return self.query(query)[0]
+
+    def count(self, configSpace):
+        query = "SELECT COUNT(*) FROM results WHERE config_space = ?"
+        return self.query(query, (configSpace,))[0]
+
+    # rows of (config_script, lut, ff, bram, dsp, clock, latency)
+    def configurations(self, configSpace):
+        query = """
+        SELECT config_script, lut, ff, bram, dsp, clock, latency
+        FROM results WHERE config_space = ? AND latency > 0
+        ORDER BY rowid
+        """
+        return self.query(query, (configSpace,))
+
+
+if __name__ == "__main__":
+    exportSnapshot()
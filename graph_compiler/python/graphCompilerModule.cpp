@@ -0,0 +1,149 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "commandLine.h"
+#include "directives.h"
+#include "gnn/graphCoarsener.h"
+#include "gnn/graphGenerator.h"
+#include "gnn/loopTree.h"
+#include "utility.h"
+#include "rose.h"
+
+#include <memory>
+#include <sstream>
+
+namespace py = pybind11;
+
+namespace {
+
+// A kernel parsed once by the ROSE frontend,
+// which can then be turned into a graph for any number of directive sets
+class Kernel {
+  public:
+    Kernel(const std::string &src, const std::string &top, const std::vector<std::string> &args) {
+        static bool roseInitialized = false;
+        if (!roseInitialized) {
+            ROSE_INITIALIZE;
+            roseInitialized = true;
+        }
+
+        // go through the same command line parsing as the executable
+        baseArgs = {"graph_compiler", "--top", top, "--src", src};
+        baseArgs.insert(baseArgs.end(), args.begin(), args.end());
+        parserResult = AIR::CommandLine::parseCommandLine(baseArgs);
+
+        project = frontend(AIR::CommandLine::getFrontendArgs(parserResult));
+        ROSE_ASSERT(project != NULL);
+
+        SgGlobal *globalScope = SageInterface::getFirstGlobalScope(project);
+        SageBuilder::pushScopeStack(isSgScopeStatement(globalScope));
+
+        topLevelFunctionDef = AIR::getTopLevelFunctionDef(project, top);
+        directiveApplier = std::make_unique<AIR::DirectiveApplier>(project, topLevelFunctionDef);
+    }
+
+    // the same dot text the executable prints,
+    // collapsed into bb, loop or function supernodes if coarsen is set
+    std::string dot(const std::string &directives, const std::string &coarsen) {
+        std::ostringstream out;
+        run(directives, out, coarsen);
+        return out.str();
+    }
+
+    // the dot text of each view, named with the switches it adds to the kernel's,
+    // all from one application of the directives
+    std::map<std::string, std::string> dotViews(const std::string &directives,
+                                                const std::map<std::string, std::vector<std::string>> &views) {
+        directiveApplier->apply(directives);
+
+        std::map<std::string, std::string> graphs;
+        for (const std::pair<const std::string, std::vector<std::string>> &view : views) {
+            std::ostringstream out;
+            generate(getViewResult(view.second), out, "");
+            graphs[view.first] = out.str();
+        }
+        return graphs;
+    }
+
+    // only the analysis results, the graph isn't printed so this is much cheaper
+    std::map<std::string, double> estimate(const std::string &directives) {
+        directiveApplier->apply(directives);
+
+        GNN::GraphGenerator graphGen = GNN::GraphGenerator(parserResult);
+        graphGen.runEstimates = true;
+        graphGen.generateGraph(topLevelFunctionDef);
+
+        std::map<std::string, double> stats;
+        for (GNN::GraphGenerator::Stat &stat : graphGen.stats) {
+            stats[stat.name] = stat.value;
+        }
+        return stats;
+    }
+
+    // the loop nest as JSON, the same as --loop_tree writes
+    std::string loopTree(const std::string &directives) {
+        directiveApplier->apply(directives);
+
+        GNN::GraphGenerator graphGen = GNN::GraphGenerator(parserResult);
+        graphGen.runEstimates = true;
+        graphGen.generateGraph(topLevelFunctionDef);
+
+        std::ostringstream out;
+        GNN::printLoopTree(&graphGen, out);
+        return out.str();
+    }
+
+  private:
+    std::vector<std::string> baseArgs;
+    Sawyer::CommandLine::ParserResult parserResult;
+    // parsed once for each set of switches a view adds
+    std::map<std::vector<std::string>, Sawyer::CommandLine::ParserResult> viewResults;
+    SgProject *project;
+    SgFunctionDefinition *topLevelFunctionDef;
+    std::unique_ptr<AIR::DirectiveApplier> directiveApplier;
+    Sawyer::CommandLine::ParserResult &getViewResult(const std::vector<std::string> &switches) {
+        if (!viewResults.count(switches)) {
+            std::vector<std::string> viewArgs = baseArgs;
+            viewArgs.insert(viewArgs.end(), switches.begin(), switches.end());
+            viewResults[switches] = AIR::CommandLine::parseCommandLine(viewArgs);
+        }
+        return viewResults[switches];
+    }
+
+    void run(const std::string &directives, std::ostream &out, const std::string &coarsen = "") {
+        directiveApplier->apply(directives);
+        generate(parserResult, out, coarsen);
+    }
+
+    void generate(Sawyer::CommandLine::ParserResult &viewResult, std::ostream &out, const std::string &coarsen) {
+        GNN::GraphGenerator graphGen = GNN::GraphGenerator(viewResult);
+        graphGen.generateGraph(topLevelFunctionDef);
+
+        std::streambuf *coutbuf = std::cout.rdbuf(out.rdbuf());
+        try {
+            if (coarsen.empty()) {
+                graphGen.printGraph();
+            } else {
+                GNN::GraphCoarsener(&graphGen, coarsen).print();
+            }
+        } catch (...) {
+            std::cout.rdbuf(coutbuf);
+            throw;
+        }
+        std::cout.rdbuf(coutbuf);
+    }
+};
+
+} // namespace
+
+PYBIND11_MODULE(graph_compiler_py, m) {
+    m.doc() = "In-process access to the graph compiler";
+
+    py::class_<Kernel>(m, "Kernel")
+        .def(py::init<const std::string &, const std::string &, const std::vector<std::string> &>(), py::arg("src"),
+             py::arg("top"), py::arg("args") = std::vector<std::string>())
+        .def("dot", &Kernel::dot, py::arg("directives") = "", py::arg("coarsen") = "")
+        .def("dot_views", &Kernel::dotViews, py::arg("directives"), py::arg("views"))
+        .def("estimate", &Kernel::estimate, py::arg("directives") = "")
+        .def("loop_tree", &Kernel::loopTree, py::arg("directives") = "");
+}
@@ -1,5 +1,9 @@
 #include "commandLine.h"
 #include "gnn/args.h"
+
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <fstream>
 namespace {
 
 void addHelpArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
@@ -29,7 +33,8 @@ void addTopArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
     top.argument("functionName", anyParser());
 
     // specify arg description in man page
-    top.doc("Specify the top level function of the kernel.");
+    top.doc("Specify the top level function of the kernel. Several can be given separated by commas, or matched with a "
+            "glob pattern such as get_delta_matrix_weights*, each graph is then written to outputs/top.dot.");
 
     // register arg
     inputArgGroup.insert(top);
@@ -52,6 +57,81 @@ void addSrcArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
     inputArgGroup.insert(src);
 }
 
+void addLoopTreeArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
+    using namespace Sawyer::CommandLine;
+
+    // create loop tree arg
+    Switch loopTree = Switch(GNN::LOOP_TREE);
+
+    // specify that the loop tree arg takes a string as argument
+    // argument name is "fileName" in the man page
+    loopTree.argument("fileName", anyParser());
+
+    // specify arg description in man page
+    loopTree.doc("Write the loop nest, with per-loop bounds, pragmas and operation counts, to a JSON file.");
+
+    // register arg
+    inputArgGroup.insert(loopTree);
+}
+
+void addCoarsenArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
+    using namespace Sawyer::CommandLine;
+
+    // create coarsen arg
+    Switch coarsen = Switch(GNN::COARSEN);
+
+    // specify that the coarsen arg takes a string as argument
+    // argument name is "level" in the man page
+    coarsen.argument("level", anyParser());
+
+    // specify arg description in man page
+    coarsen.doc("Print the graph with each bb, loop or function collapsed into a single node.");
+
+    // register arg
+    inputArgGroup.insert(coarsen);
+}
+
+void addViewArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
+    using namespace Sawyer::CommandLine;
+
+    // create view arg
+    Switch view = Switch(GNN::VIEW);
+
+    // specify that the view arg takes a string as argument, and can be given more than once
+    // argument name is "view" in the man page
+    view.argument("view", anyParser());
+    view.whichValue(SAVE_ALL);
+
+    // specify arg description in man page
+    view.doc("Also make a graph with these switches added, from the same parse of the source. Given as name=switches, "
+             "or as a dataset config file, whose first line is the invocation, named after the file. Each view is "
+             "written to outputs/top_name.dot, so view names must differ. A view can only add switches, it can't "
+             "turn off one given on the base command line, so leave off any switch that views differ by.");
+
+    // register arg
+    inputArgGroup.insert(view);
+}
+
+void addServeArg(Sawyer::CommandLine::SwitchGroup &inputArgGroup) {
+    using namespace Sawyer::CommandLine;
+
+    // create serve arg
+    Switch serve = Switch(GNN::SERVE);
+
+    // specify that the serve arg takes a string as argument
+    // argument name is "socket" in the man page
+    serve.argument("socket", anyParser());
+
+    // specify arg description in man page
+    serve.doc("Parse the source once, then make graphs from it for requests on this unix socket. Each request is a "
+              "line of switches added to the ones given here, handled in a worker forked from the parsed process. "
+              "Each graph is sent back after a \"// graph name\" line, with its stats as comments after it, then the "
+              "line \"// exit 0\", or how the worker failed.");
+
+    // register arg
+    inputArgGroup.insert(serve);
+}
+
 Sawyer::CommandLine::SwitchGroup specifyInputArgs() {
     using namespace Sawyer::CommandLine;
 
@@ -61,6 +141,11 @@ Sawyer::CommandLine::SwitchGroup specifyInputArgs() {
     addHelpArg(inputArgGroup);
     addTopArg(inputArgGroup);
     addSrcArg(inputArgGroup);
+    addLoopTreeArg(inputArgGroup);
+    addCoarsenArg(inputArgGroup);
+    addViewArg(inputArgGroup);
+    addJobsArg(inputArgGroup);
+    addServeArg(inputArgGroup);
 
     for (auto argTuple : GNN::ARGS) {
         std::string argName = argTuple.first;
@@ -117,6 +202,15 @@ Sawyer::CommandLine::ParserResult parseCommandLine(int argc, char *argv[]) {
     return parserResult;
 }
 
+Sawyer::CommandLine::ParserResult parseCommandLine(std::vector<std::string> args) {
+    std::vector<char *> argv;
+    for (std::string &arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    return parseCommandLine(args.size(), argv.data());
+}
+
 // Some CLI args are for the AIR tool and some are for the input code
 // Take only the args for the input code
 std::vector<std::string> getFrontendArgs(Sawyer::CommandLine::ParserResult parserResult) {
@@ -138,11 +232,66 @@ std::vector<std::string> getFrontendArgs(Sawyer::CommandLine::ParserResult parse
     return frontendArgs;
 }
 
-std::string getTopLevelFunctionName(Sawyer::CommandLine::ParserResult parserResult) {
+std::vector<std::string> getTopLevelFunctionNames(Sawyer::CommandLine::ParserResult parserResult) {
     if (!parserResult.have("top")) {
         throw std::invalid_argument("Please specify the top level function of the kernel using the --top arg.");
     }
-    return parserResult.parsed("top").back().asString();
+
+    std::vector<std::string> names;
+    std::string top = parserResult.parsed("top").back().asString();
+    boost::split(names, top, boost::is_any_of(","));
+    names.erase(std::remove(names.begin(), names.end(), ""), names.end());
+    if (names.empty()) {
+        throw std::invalid_argument("Please specify the top level function of the kernel using the --top arg.");
+    }
+    return names;
+}
+
+std::vector<std::pair<std::string, std::vector<std::string>>> getViews(Sawyer::CommandLine::ParserResult parserResult) {
+    std::vector<std::pair<std::string, std::vector<std::string>>> views;
+    if (!parserResult.have(GNN::VIEW)) {
+        return views;
+    }
+
+    for (const Sawyer::CommandLine::ParsedValue &value : parserResult.parsed(GNN::VIEW)) {
+        std::string view = value.asString();
+        std::string name;
+        std::string switches;
+
+        size_t equals = view.find('=');
+        if (equals != std::string::npos) {
+            name = view.substr(0, equals);
+            switches = view.substr(equals + 1);
+        } else {
+            // a config file is named after the file, and its first word is the program
+            std::ifstream configFile(view);
+            if (!configFile) {
+                throw std::invalid_argument("Couldn't open view config " + view);
+            }
+            std::getline(configFile, switches);
+            size_t programEnd = switches.find(' ');
+            switches = programEnd == std::string::npos ? "" : switches.substr(programEnd + 1);
+
+            // only the last extension is dropped, so a.v1.txt and a.v2.txt stay apart
+            name = view.substr(view.find_last_of('/') + 1);
+            name = name.substr(0, name.find_last_of('.'));
+        }
+
+        // views with the same name would be written over each other
+        for (std::pair<std::string, std::vector<std::string>> &other : views) {
+            if (other.first == name) {
+                throw std::invalid_argument("Two views are named " + name + ", give each view its own name.");
+            }
+        }
+
+        std::vector<std::string> words;
+        boost::algorithm::trim(switches);
+        if (!switches.empty()) {
+            boost::algorithm::split(words, switches, boost::is_any_of(" "), boost::token_compress_on);
+        }
+        views.push_back(std::make_pair(name, words));
+    }
+    return views;
 }
 } // namespace CommandLine
 } // namespace AIR
\ No newline at end of file
@@ -13,13 +13,19 @@ namespace CommandLine {
 
 // Use the Sawyer library that comes with Rose to parse CLI inputs
 Sawyer::CommandLine::ParserResult parseCommandLine(int argc, char *argv[]);
+// the same, for a command line held as strings, starting with the program name
+Sawyer::CommandLine::ParserResult parseCommandLine(std::vector<std::string> args);
 
 // Some CLI args are for the AIR tool and some are for the Rose frontend
 // Take only the args for the Rose frontend
 std::vector<std::string> getFrontendArgs(Sawyer::CommandLine::ParserResult parserResult);
 
-// Extract the "top" argument, the top level function of the kernel
-std::string getTopLevelFunctionName(Sawyer::CommandLine::ParserResult parserResult);
+// Extract the "top" argument, the top level functions of the kernels
+// Each is a function name or a glob pattern matching several
+std::vector<std::string> getTopLevelFunctionNames(Sawyer::CommandLine::ParserResult parserResult);
+
+// The name and extra switches of each --view, in the order they were given
+std::vector<std::pair<std::string, std::vector<std::string>>> getViews(Sawyer::CommandLine::ParserResult parserResult);
 } // namespace CommandLine
 } // namespace AIR
 
@@ -0,0 +1,228 @@
+#include "directives.h"
+#include "rose.h"
+
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+
+namespace {
+
+// loop labels are given as "function/label", only the label is needed
+std::string getLabel(const std::string &path) {
+    std::string label = boost::algorithm::replace_all_copy(path, "\"", "");
+    std::vector<std::string> labels;
+    boost::algorithm::split(labels, label, boost::is_any_of("/"));
+    return labels.back();
+}
+
+std::string getOption(const std::vector<std::string> &words, const std::string &option, const std::string &otherwise) {
+    for (int i = 0; i + 1 < words.size(); i++) {
+        if (words[i] == option) {
+            return words[i + 1];
+        }
+    }
+    return otherwise;
+}
+
+} // namespace
+
+namespace AIR {
+
+DirectiveApplier::DirectiveApplier(SgProject *project, SgFunctionDefinition *topLevelFunctionDef) {
+    // like apply_directives.py, only look from the top level function onwards
+    bool reachedTop = false;
+    std::vector<SgNode *> defs = NodeQuery::querySubTree(project, V_SgFunctionDefinition);
+    for (SgNode *node : defs) {
+        SgFunctionDefinition *functionDef = isSgFunctionDefinition(node);
+        if (functionDef == topLevelFunctionDef) {
+            reachedTop = true;
+        }
+        if (reachedTop) {
+            functionDefs.push_back(functionDef);
+        }
+    }
+}
+
+void DirectiveApplier::apply(const std::string &directives) {
+    clear();
+
+    std::vector<std::string> directiveLines;
+    boost::algorithm::split(directiveLines, directives, boost::is_any_of("\n"));
+    for (std::string directive : directiveLines) {
+        boost::algorithm::trim(directive);
+        if (!directive.empty()) {
+            applyDirective(directive);
+        }
+    }
+}
+
+void DirectiveApplier::clear() {
+    for (SgPragmaDeclaration *pragma : insertedPragmas) {
+        SageInterface::removeStatement(pragma);
+    }
+    insertedPragmas.clear();
+}
+
+void DirectiveApplier::applyDirective(const std::string &directive) {
+    std::vector<std::string> words;
+    boost::algorithm::split(words, directive, boost::is_any_of(" "), boost::token_compress_on);
+
+    if (words[0] == "set_directive_unroll") {
+        std::string factor = getOption(words, "-factor", "");
+        if (factor.empty()) {
+            throw std::runtime_error("Unroll directive without a factor: " + directive);
+        }
+        if (std::stoi(factor) > 1) {
+            addLoopPragma(getLabel(words.back()), "HLS UNROLL factor=" + factor);
+        }
+    } else if (words[0] == "set_directive_pipeline") {
+        std::string pragmaText = "HLS PIPELINE";
+        std::string ii = getOption(words, "-II", "");
+        if (!ii.empty()) {
+            pragmaText += " II=" + ii;
+        }
+        if (std::find(words.begin(), words.end(), "-rewind") != words.end()) {
+            pragmaText += " rewind";
+        }
+        if (std::find(words.begin(), words.end(), "-off") != words.end()) {
+            pragmaText += " off";
+        }
+        addLoopPragma(getLabel(words.back()), pragmaText);
+    } else if (words[0] == "set_directive_loop_flatten") {
+        bool off = std::find(words.begin(), words.end(), "-off") != words.end();
+        addLoopPragma(getLabel(words.back()), off ? "HLS LOOP_FLATTEN off" : "HLS LOOP_FLATTEN");
+    } else if (words[0] == "set_directive_loop_merge") {
+        // merging can be set on a function body or a loop body
+        std::string location = boost::algorithm::replace_all_copy(words.back(), "\"", "");
+        if (location.find("/") == std::string::npos) {
+            addFunctionPragma(location, "HLS LOOP_MERGE");
+        } else {
+            addLoopPragma(getLabel(location), "HLS LOOP_MERGE");
+        }
+    } else if (words[0] == "set_directive_array_partition") {
+        std::string type = getOption(words, "-type", "");
+        if (type != "cyclic" && type != "block" && type != "complete") {
+            throw std::runtime_error("Unknown array partition type: " + directive);
+        }
+        std::string factor = getOption(words, "-factor", "1");
+        std::string dim = getOption(words, "-dim", "1");
+        std::string variable = words.back();
+        addVariablePragma(variable, "HLS ARRAY_PARTITION type=" + type + " variable=" + variable + " factor=" +
+                                        factor + " dim=" + dim);
+    } else if (words[0] == "set_directive_array_reshape") {
+        std::string type = getOption(words, "-type", "");
+        if (type != "cyclic" && type != "block" && type != "complete") {
+            throw std::runtime_error("Unknown array reshape type: " + directive);
+        }
+        std::string factor = getOption(words, "-factor", "1");
+        std::string dim = getOption(words, "-dim", "1");
+        std::string variable = words.back();
+        addVariablePragma(variable, "HLS ARRAY_RESHAPE type=" + type + " variable=" + variable + " factor=" +
+                                        factor + " dim=" + dim);
+    } else if (words[0] == "set_directive_interface") {
+        std::string mode = getOption(words, "-mode", "");
+        if (mode.empty()) {
+            throw std::runtime_error("Interface directive without a mode: " + directive);
+        }
+        std::string variable = words.back();
+        // the function's control port isn't a variable
+        if (variable != "return") {
+            std::string pragmaText = "HLS INTERFACE " + mode + " port=" + variable;
+            for (std::string option : {"bundle", "depth", "storage_type", "max_read_burst_length",
+                                       "max_write_burst_length", "max_widen_bitwidth"}) {
+                std::string value = getOption(words, "-" + option, "");
+                if (!value.empty()) {
+                    pragmaText += " " + option + "=" + value;
+                }
+            }
+            addVariablePragma(variable, pragmaText);
+        }
+    } else if (words[0] == "set_directive_resource") {
+        std::string core = getOption(words, "-core", "");
+        std::string variable = words.back();
+        addVariablePragma(variable, "HLS RESOURCE core=" + core + " variable=" + variable);
+    }
+    // any other directive is ignored, the same as apply_directives.py
+}
+
+// loop pragmas go at the top of the loop body
+void DirectiveApplier::addLoopPragma(const std::string &loopLabel, const std::string &pragmaText) {
+    for (SgFunctionDefinition *functionDef : functionDefs) {
+        std::vector<SgNode *> labels = NodeQuery::querySubTree(functionDef, V_SgLabelStatement);
+        for (SgNode *node : labels) {
+            SgLabelStatement *labelStatement = isSgLabelStatement(node);
+            if (labelStatement->get_label().getString() != loopLabel) {
+                continue;
+            }
+
+            SgStatement *loop = labelStatement->get_statement();
+            if (!loop) {
+                loop = SageInterface::getNextStatement(labelStatement);
+            }
+
+            SgStatement *body = nullptr;
+            if (SgForStatement *forStatement = isSgForStatement(loop)) {
+                body = forStatement->get_loop_body();
+            } else if (SgWhileStmt *whileStatement = isSgWhileStmt(loop)) {
+                body = whileStatement->get_body();
+            }
+
+            SgBasicBlock *bb = isSgBasicBlock(body);
+            if (!bb) {
+                throw std::runtime_error("Label " + loopLabel + " isn't on a loop with a body");
+            }
+
+            SgPragmaDeclaration *pragma = SageBuilder::buildPragmaDeclaration(pragmaText, bb);
+            SageInterface::prependStatement(pragma, bb);
+            insertedPragmas.push_back(pragma);
+            return;
+        }
+    }
+    throw std::runtime_error("Couldn't find loop label " + loopLabel);
+}
+
+// function pragmas go at the top of the function body
+void DirectiveApplier::addFunctionPragma(const std::string &functionName, const std::string &pragmaText) {
+    for (SgFunctionDefinition *functionDef : functionDefs) {
+        if (functionDef->get_declaration()->get_name().getString() == functionName) {
+            SgBasicBlock *body = functionDef->get_body();
+            SgPragmaDeclaration *pragma = SageBuilder::buildPragmaDeclaration(pragmaText, body);
+            SageInterface::prependStatement(pragma, body);
+            insertedPragmas.push_back(pragma);
+            return;
+        }
+    }
+    throw std::runtime_error("Couldn't find function " + functionName);
+}
+
+// variable pragmas go at the top of the function for parameters,
+// and after the declaration for local variables
+void DirectiveApplier::addVariablePragma(const std::string &variableName, const std::string &pragmaText) {
+    for (SgFunctionDefinition *functionDef : functionDefs) {
+        SgBasicBlock *body = functionDef->get_body();
+
+        for (SgInitializedName *param : functionDef->get_declaration()->get_args()) {
+            if (param->get_name().getString() == variableName) {
+                SgPragmaDeclaration *pragma = SageBuilder::buildPragmaDeclaration(pragmaText, body);
+                SageInterface::prependStatement(pragma, body);
+                insertedPragmas.push_back(pragma);
+                return;
+            }
+        }
+
+        std::vector<SgNode *> varDecs = NodeQuery::querySubTree(body, V_SgVariableDeclaration);
+        for (SgNode *node : varDecs) {
+            SgVariableDeclaration *varDec = isSgVariableDeclaration(node);
+            for (SgInitializedName *variable : varDec->get_variables()) {
+                if (variable->get_name().getString() == variableName) {
+                    SgPragmaDeclaration *pragma = SageBuilder::buildPragmaDeclaration(pragmaText, varDec->get_scope());
+                    SageInterface::insertStatementAfter(varDec, pragma);
+                    insertedPragmas.push_back(pragma);
+                    return;
+                }
+            }
+        }
+    }
+    throw std::runtime_error("Couldn't find variable " + variableName);
+}
+
+} // namespace AIR
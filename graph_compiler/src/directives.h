@@ -0,0 +1,38 @@
+#ifndef AIR_DIRECTIVES_H
+#define AIR_DIRECTIVES_H
+
+#include "rose.h"
+#include <string>
+#include <vector>
+
+namespace AIR {
+
+// Applies a Vivado HLS directive script (set_directive_* lines, as stored in DB4HLS)
+// to an already parsed kernel by inserting the matching pragmas into the AST.
+// This does what apply_directives.py does to the source text,
+// so the kernel only has to be parsed once for a whole directive sweep.
+class DirectiveApplier {
+  public:
+    DirectiveApplier(SgProject *project, SgFunctionDefinition *topLevelFunctionDef);
+
+    // remove the pragmas from the previous directive set and insert the new ones
+    void apply(const std::string &directives);
+
+    // remove every pragma inserted so far, leaving the original AST
+    void clear();
+
+  private:
+    void applyDirective(const std::string &directive);
+
+    void addLoopPragma(const std::string &loopLabel, const std::string &pragmaText);
+    void addFunctionPragma(const std::string &functionName, const std::string &pragmaText);
+    void addVariablePragma(const std::string &variableName, const std::string &pragmaText);
+
+    // function definitions from the top level function to the end of the file, in source order
+    std::vector<SgFunctionDefinition *> functionDefs;
+
+    std::vector<SgPragmaDeclaration *> insertedPragmas;
+};
+
+} // namespace AIR
+#endif
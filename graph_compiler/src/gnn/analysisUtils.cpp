@@ -0,0 +1,196 @@
+#include "analysisUtils.h"
+#include "edge.h"
+#include <algorithm>
+
+namespace GNN {
+namespace Analysis {
+
+int getBitwidth(Node *node) {
+    TypeStruct type;
+    try {
+        type = node->getType();
+    } catch (...) {
+        return 0;
+    }
+    if (type.isVoid || type.stringOverride) {
+        return 0;
+    }
+    if (node->rangeBitwidth > 0 && type.dataType == DataType::INTEGER) {
+        return std::min(type.bitwidth, node->rangeBitwidth);
+    }
+    return type.bitwidth;
+}
+
+bool isFloat(Node *node) {
+    try {
+        TypeStruct type = node->getType();
+        return !type.isVoid && !type.stringOverride && type.dataType == DataType::FLOAT;
+    } catch (...) {
+        return false;
+    }
+}
+
+std::string getOpKind(Node *node) {
+    if (ArithmeticNode *arithmetic = dynamic_cast<ArithmeticNode *>(node)) {
+        return arithmetic->opType;
+    } else if (dynamic_cast<ComparisonNode *>(node)) {
+        return "Comparison";
+    } else if (dynamic_cast<CastToFloatNode *>(node)) {
+        return "CastToFloat";
+    } else if (dynamic_cast<SelectNode *>(node)) {
+        return "Select";
+    } else if (dynamic_cast<FNegNode *>(node)) {
+        return "FNeg";
+    } else if (UnaryOpNode *unary = dynamic_cast<UnaryOpNode *>(node)) {
+        return unary->opType;
+    } else if (dynamic_cast<ReadNode *>(node)) {
+        return "Read";
+    } else if (dynamic_cast<WriteNode *>(node)) {
+        return "Write";
+    } else if (dynamic_cast<DerefNode *>(node)) {
+        return "Deref";
+    } else if (dynamic_cast<FunctionCallNode *>(node)) {
+        return "Call";
+    }
+    return "";
+}
+
+bool hasConstantOperand(Node *node) {
+    if (ArithmeticNode *arithmetic = dynamic_cast<ArithmeticNode *>(node)) {
+        if (arithmetic->arithmeticEdge) {
+            return arithmetic->arithmeticEdge->lhs->getVariant() == NodeVariant::CONSTANT ||
+                   arithmetic->arithmeticEdge->rhs->getVariant() == NodeVariant::CONSTANT;
+        }
+    }
+    return false;
+}
+
+double getReplication(Node *node) {
+    if (node->unrollFactor.full < 1) {
+        return 1;
+    }
+    return node->unrollFactor.full;
+}
+
+std::map<Node *, std::vector<Node *>> getDataflowPredecessors(GraphGenerator *graphGenerator) {
+    std::map<Node *, std::vector<Node *>> predecessors;
+    for (std::unique_ptr<Edge> &edgePtr : graphGenerator->edges_unq) {
+        Edge *edge = edgePtr.get();
+        if (ArithmeticUnitEdge *arithmeticEdge = dynamic_cast<ArithmeticUnitEdge *>(edge)) {
+            predecessors[arithmeticEdge->unit].push_back(arithmeticEdge->lhs);
+            predecessors[arithmeticEdge->unit].push_back(arithmeticEdge->rhs);
+        } else if (dynamic_cast<DataFlowEdge *>(edge) || dynamic_cast<SextDataFlowEdge *>(edge) ||
+                   dynamic_cast<ImplicitCastDataFlowEdge *>(edge) || dynamic_cast<ParameterLoadDataFlowEdge *>(edge) ||
+                   dynamic_cast<ResolvedMemoryAddressEdge *>(edge)) {
+            if (edge->source && edge->destination) {
+                predecessors[edge->destination].push_back(edge->source);
+            }
+        }
+    }
+    return predecessors;
+}
+
+std::map<Node *, Node *> getMemoryElements(GraphGenerator *graphGenerator) {
+    std::map<Node *, Node *> memoryElements;
+    for (std::unique_ptr<Edge> &edgePtr : graphGenerator->edges_unq) {
+        Edge *edge = edgePtr.get();
+        if (dynamic_cast<ReadMemoryElementEdge *>(edge)) {
+            memoryElements[edge->destination] = edge->source;
+        } else if (dynamic_cast<WriteMemoryElementEdge *>(edge)) {
+            memoryElements[edge->source] = edge->destination;
+        }
+    }
+    return memoryElements;
+}
+
+DerefNode *getAddress(std::map<Node *, std::vector<Node *>> &predecessors, Node *access) {
+    if (predecessors.count(access)) {
+        for (Node *predecessor : predecessors[access]) {
+            if (DerefNode *deref = dynamic_cast<DerefNode *>(predecessor)) {
+                return deref;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool isScalarElement(Node *memoryElement) {
+    NodeVariant variant = memoryElement->getVariant();
+    return variant == NodeVariant::LOCAL_SCALAR || variant == NodeVariant::PARAMETER_SCALAR;
+}
+
+std::vector<int> getArrayDimensions(Node *array) {
+    std::vector<int> dimensions;
+    if (LocalArrayNode *localArray = dynamic_cast<LocalArrayNode *>(array)) {
+        dimensions = localArray->dimensions;
+        if (dimensions.empty()) {
+            dimensions.push_back(localArray->numElements);
+        }
+    } else if (ExternalArrayNode *externalArray = dynamic_cast<ExternalArrayNode *>(array)) {
+        dimensions.push_back(externalArray->numElements);
+    } else if (SubParameterArrayNode *parameterArray = dynamic_cast<SubParameterArrayNode *>(array)) {
+        dimensions.push_back(parameterArray->numElements);
+    }
+    return dimensions;
+}
+
+// complete partitioning gives a bank per index of that dimension
+double getNumBanks(Node *array) {
+    std::vector<int> dimensions = getArrayDimensions(array);
+
+    double banks = 1;
+    std::string types[2] = {array->partitionType1, array->partitionType2};
+    int factors[2] = {array->partitionFactor1, array->partitionFactor2};
+    for (int i = 0; i < 2 && i < dimensions.size(); i++) {
+        if (types[i] == "complete") {
+            banks *= dimensions[i];
+        } else if (factors[i] > 1) {
+            banks *= std::min(factors[i], dimensions[i]);
+        }
+    }
+    return banks;
+}
+
+// local arrays get a dual port ram unless a resource pragma says otherwise,
+// interface arrays get whatever their storage type or interface mode is
+int getNumPorts(GraphGenerator *graphGenerator, Node *array) {
+    std::string name = getArrayName(array);
+    if (array->getVariant() == NodeVariant::LOCAL_ARRAY) {
+        std::map<std::string, std::string> &resourceTypes = graphGenerator->variableMapper->resourceTypeMap;
+        if (resourceTypes.count(name) && resourceTypes[name].find("1P") != std::string::npos) {
+            return 1;
+        }
+        return 2;
+    }
+    if (graphGenerator->pragmaParser->getPortType(name).find("2") != std::string::npos) {
+        return 2;
+    }
+    return 1;
+}
+
+std::string getArrayName(Node *array) {
+    if (LocalArrayNode *localArray = dynamic_cast<LocalArrayNode *>(array)) {
+        return localArray->variableName;
+    } else if (ExternalArrayNode *externalArray = dynamic_cast<ExternalArrayNode *>(array)) {
+        return externalArray->variableName;
+    } else if (SubParameterArrayNode *parameterArray = dynamic_cast<SubParameterArrayNode *>(array)) {
+        return parameterArray->variableName;
+    }
+    return "";
+}
+
+std::string getElementName(Node *element) {
+    std::string name = getArrayName(element);
+    if (!name.empty()) {
+        return name;
+    }
+    if (LocalScalarNode *scalar = dynamic_cast<LocalScalarNode *>(element)) {
+        return scalar->description;
+    } else if (ParameterScalarNode *scalar = dynamic_cast<ParameterScalarNode *>(element)) {
+        return scalar->variableName;
+    }
+    return "unknown";
+}
+
+} // namespace Analysis
+} // namespace GNN
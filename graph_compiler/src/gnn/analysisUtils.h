@@ -0,0 +1,67 @@
+#ifndef GNN_ANALYSIS_UTILS_H
+#define GNN_ANALYSIS_UTILS_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class DerefNode;
+
+namespace Analysis {
+
+// bitwidth of the value a node produces, narrowed to its range with --range_bitwidth
+// 0 if the node has no numeric type
+int getBitwidth(Node *node);
+
+bool isFloat(Node *node);
+
+// the kind of operation a node is, as used for the cost tables
+// e.g. "Addition", "Comparison", "Read"
+// empty if the node isn't an operation (variables, constants, pragmas)
+std::string getOpKind(Node *node);
+
+// does an arithmetic node have a constant operand
+// shifts and multiplications by constants are much cheaper
+bool hasConstantOperand(Node *node);
+
+// the number of copies of a node's hardware the unroll factors make
+double getReplication(Node *node);
+
+// the nodes each node takes data from, built from the edges before they're printed
+// includes the operands of arithmetic units and the address of a memory access
+std::map<Node *, std::vector<Node *>> getDataflowPredecessors(GraphGenerator *graphGenerator);
+
+// the variable or array each read and write accesses
+std::map<Node *, Node *> getMemoryElements(GraphGenerator *graphGenerator);
+
+// the address calculation a read or write uses, nullptr for scalars
+DerefNode *getAddress(std::map<Node *, std::vector<Node *>> &predecessors, Node *access);
+
+// scalars live in registers, so accessing them is free
+bool isScalarElement(Node *memoryElement);
+
+// size of each dimension of an array, outermost first
+std::vector<int> getArrayDimensions(Node *array);
+
+// banks an array is split into by its partition pragmas
+double getNumBanks(Node *array);
+
+// ports on each bank of an array
+int getNumPorts(GraphGenerator *graphGenerator, Node *array);
+
+// the variable name of an array node, empty if it isn't an array
+std::string getArrayName(Node *array);
+
+// the variable name of any memory element, arrays or scalars
+std::string getElementName(Node *element);
+
+} // namespace Analysis
+} // namespace GNN
+
+#endif
@@ -33,6 +33,29 @@ const std::string ONLY_MEMORY_CONTROL_FLOW_DESC =
 const std::string PROXY_PROGRAML_DESC = "Change output details to match PrograML exactly";
 const std::string DONT_DISPLAY_TYPES_DESC = "Don't output absorbed type info on the pdf";
 const std::string ADD_NUM_CALLS_DESC = "Add the number of calls and call-sites to nodes in sub-functions";
+const std::string STATS_DESC = "Print the results of the analysis passes to cerr after the graph.";
+const std::string ADD_SCHEDULE_DESC = "Add each node's ASAP and ALAP cycle within its BB to node embeddings.";
+const std::string ADD_II_DESC =
+    "Add the estimated II of the enclosing pipelined loop, and the II its pragma asked for, to node embeddings.";
+const std::string ADD_BANK_CONFLICTS_DESC =
+    "Add the bank conflict cycles of memory accesses to node and edge embeddings, and whether each address is affine.";
+const std::string ADD_BB_GRAPH_DESC = "Add the BB level CFG and the number of BBs to the graph as graph level attributes.";
+const std::string ADD_LOOP_ID_DESC = "Add the ID of the innermost enclosing loop, and of the loop it was flattened "
+                                     "or merged into, to node embeddings, -1 outside loops.";
+const std::string VALUE_NUMBERING_DESC =
+    "Share equivalent arithmetic, comparisons, reads and addresses across BBs wherever their inputs aren't redefined.";
+const std::string ELIMINATE_DEAD_NODES_DESC =
+    "Remove nodes that don't reach a write to external memory, a return value or a call, and their edges.";
+const std::string RANGE_BITWIDTH_DESC =
+    "Find the range of every integer value and narrow its bitwidth to fit, for sexts, types and the cost estimates.";
+const std::string ADD_DATAFLOW_DESC =
+    "Add the DATAFLOW stage and region of each node to node embeddings, and channel edges between stages.";
+const std::string ADD_BURSTS_DESC =
+    "Add the ARRAY_RESHAPE of arrays, and the sequential run, widening and m_axi burst length of each memory access, to "
+    "node embeddings.";
+const std::string BANK_NODES_DESC = "With --allocas_to_mem_elems, give each bank of a partitioned array its own memory "
+                                    "element node, and connect each access to the banks its unrolled copies reach.";
+const std::string ADD_GRAPH_FEATURES_DESC = "Add the results of the analysis passes to the graph as graph level attributes.";
 } // namespace
 
 namespace GNN {
@@ -61,6 +84,26 @@ const std::string ONLY_MEMORY_CONTROL_FLOW = "only_memory_control_flow";
 const std::string PROXY_PROGRAML = "proxy_programl";
 const std::string DONT_DISPLAY_TYPES = "no_type_display";
 const std::string ADD_NUM_CALLS = "add_num_calls";
+const std::string STATS = "stats";
+const std::string ADD_GRAPH_FEATURES = "add_graph_features";
+const std::string ADD_SCHEDULE = "add_schedule";
+const std::string ADD_II = "add_ii";
+const std::string ADD_BANK_CONFLICTS = "add_bank_conflicts";
+const std::string ADD_BB_GRAPH = "add_bb_graph";
+const std::string ADD_LOOP_ID = "add_loop_id";
+const std::string VALUE_NUMBERING = "value_numbering";
+const std::string ELIMINATE_DEAD_NODES = "eliminate_dead_nodes";
+const std::string RANGE_BITWIDTH = "range_bitwidth";
+const std::string ADD_DATAFLOW = "add_dataflow";
+const std::string ADD_BURSTS = "add_bursts";
+const std::string BANK_NODES = "bank_nodes";
+
+// switches that take a value, registered in commandLine.cpp
+const std::string LOOP_TREE = "loop_tree";
+const std::string COARSEN = "coarsen";
+const std::string VIEW = "view";
+const std::string JOBS = "jobs";
+const std::string SERVE = "serve";
 
 const std::pair<std::string, std::string> ARGS[] = {
     std::make_pair(IGNORE_CONTROL_FLOW, IGNORE_CONTROL_FLOW_DESC),
@@ -86,7 +129,20 @@ const std::pair<std::string, std::string> ARGS[] = {
     std::make_pair(PROXY_PROGRAML, PROXY_PROGRAML_DESC),
     std::make_pair(DONT_DISPLAY_TYPES, DONT_DISPLAY_TYPES_DESC),
     std::make_pair(ADD_NODE_TYPE, ADD_NODE_TYPE_DESC),
-    std::make_pair(ADD_NUM_CALLS, ADD_NUM_CALLS_DESC)};
+    std::make_pair(ADD_NUM_CALLS, ADD_NUM_CALLS_DESC),
+    std::make_pair(STATS, STATS_DESC),
+    std::make_pair(ADD_GRAPH_FEATURES, ADD_GRAPH_FEATURES_DESC),
+    std::make_pair(ADD_SCHEDULE, ADD_SCHEDULE_DESC),
+    std::make_pair(ADD_II, ADD_II_DESC),
+    std::make_pair(ADD_BANK_CONFLICTS, ADD_BANK_CONFLICTS_DESC),
+    std::make_pair(ADD_BB_GRAPH, ADD_BB_GRAPH_DESC),
+    std::make_pair(ADD_LOOP_ID, ADD_LOOP_ID_DESC),
+    std::make_pair(VALUE_NUMBERING, VALUE_NUMBERING_DESC),
+    std::make_pair(ELIMINATE_DEAD_NODES, ELIMINATE_DEAD_NODES_DESC),
+    std::make_pair(RANGE_BITWIDTH, RANGE_BITWIDTH_DESC),
+    std::make_pair(ADD_DATAFLOW, ADD_DATAFLOW_DESC),
+    std::make_pair(ADD_BURSTS, ADD_BURSTS_DESC),
+    std::make_pair(BANK_NODES, BANK_NODES_DESC)};
 } // namespace GNN
 
 #endif
\ No newline at end of file
@@ -9,6 +9,8 @@ AstParser::AstParser(GraphGenerator *graphGenerator) : graphGenerator(graphGener
     pragmaParser = graphGenerator->pragmaParser.get();
     variableMapper = graphGenerator->variableMapper.get();
     derefTracker = graphGenerator->derefTracker.get();
+    constantFolder = graphGenerator->constantFolder.get();
+    valueNumbering = graphGenerator->valueNumbering.get();
 }
 
 void AstParser::makeVariable(SgInitializedName *varDec) {
@@ -44,6 +46,11 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
     // per function
     int numberOfReturnStatements = 0;
 
+    // the statements of a dataflow region are its stages
+    int dataflowRegion = pendingDataflowRegion;
+    pendingDataflowRegion = -1;
+    bool inStage = false;
+
     // for each line of code in a basic block
     for (SgStatement *statement : statements) {
         std::cerr << statement->unparseToString() << std::endl;
@@ -51,10 +58,57 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             continue;
         }
 
+        // loop labels are only left in when directives are applied to the AST in-process,
+        // the labelled statement is either held by the label or is the next statement
+        if (SgLabelStatement *labelStatement = isSgLabelStatement(statement)) {
+            pendingLoopLabel = labelStatement->get_label().getString();
+            if (!labelStatement->get_statement()) {
+                continue;
+            }
+            statement = labelStatement->get_statement();
+        }
+
+        // labels only name the statement straight after them
+        std::string loopLabel = pendingLoopLabel;
+        pendingLoopLabel = "";
+
+        if (inStage) {
+            graphGenerator->exitDataflowStage();
+            inStage = false;
+        }
+        // declarations are the channels between stages, not stages themselves
+        if (dataflowRegion != -1 && !isSgVariableDeclaration(statement)) {
+            std::string stageLabel = loopLabel;
+            SgFunctionDeclaration *callee = nullptr;
+            if (SgExprStatement *exprStatement = isSgExprStatement(statement)) {
+                if (SgFunctionCallExp *funcCall = isSgFunctionCallExp(exprStatement->get_expression())) {
+                    callee = AIR::getFuncDecFromCall(funcCall);
+                    stageLabel = callee->get_name();
+                }
+            }
+            if (stageLabel.empty()) {
+                stageLabel = "stage" + std::to_string(graphGenerator->dataflowRegions[dataflowRegion].stages.size());
+            }
+            graphGenerator->enterDataflowStage(dataflowRegion, stageLabel, callee);
+            inStage = true;
+        }
+
         // if the line of code is 1 or more variable declarations
         if (SgVariableDeclaration *varDecStatement = isSgVariableDeclaration(statement)) {
             // for each variable declared in the line of code
             for (SgInitializedName *varDec : varDecStatement->get_variables()) {
+                // a const scalar set to a constant never needs to exist,
+                // its reads become the constant
+                if (isConstantScalar(varDec)) {
+                    SgAssignInitializer *init = isSgAssignInitializer(varDec->get_initptr());
+                    Node *rhs = readExpression(init->get_operand());
+                    if (!setConstantValue(varDec, rhs)) {
+                        makeVariable(varDec);
+                        Node *writeNode = writeExpression(varDec, rhs);
+                        new ControlFlowEdge(writeNode);
+                    }
+                    continue;
+                }
                 makeVariable(varDec);
                 // if the variable is initialized
                 if (SgExpression *expr = isSgExpression(varDec->get_initptr())) {
@@ -156,6 +210,10 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             // get any pragmas in this bb and apply them
             pragmaParser->parsePragmas(bb);
 
+            int loopID = graphGenerator->enterLoop(loopLabel);
+            graphGenerator->loops[loopID].iterator = iterator;
+            recordLoopPragmas(loopID, bb);
+
             std::cerr << "enter loop cond" << std::endl;
 
             // unroll pragmas in a bb don't affect the condition
@@ -176,6 +234,10 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             // when we want to re-execute the condition
             PreLoopEdge *preLoopEdge = new PreLoopEdge();
 
+            // the condition runs again after the body, so nothing read before it can be reused
+            valueNumbering->enterScope();
+            valueNumbering->invalidateReads();
+
             graphGenerator->newBB();
             derefTracker->makeNewDerefMap();
             handleConditional(forStatement->get_test_expr(), branchNode, comparisonNode);
@@ -192,6 +254,9 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             }
 
             graphGenerator->newBB();
+            if (graphGenerator->loops[loopID].dataflow) {
+                pendingDataflowRegion = graphGenerator->addDataflowRegion(loopID);
+            }
             // handle the body of the for loop
             handleBB(bb->getStatementList());
 
@@ -219,6 +284,9 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             // and then mark the branch node as the predecessor
             new LoopBackEdge(preLoopEdge, branchNode);
 
+            valueNumbering->exitScope();
+            graphGenerator->exitLoop();
+
             // unapply any pragmas from this bb
             pragmaParser->unstackPragmas();
 
@@ -245,6 +313,12 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             // when we want to re-execute the condition
             PreLoopEdge *preLoopEdge = new PreLoopEdge();
 
+            // the condition is in the loop, but comes before its pragmas
+            int loopID = graphGenerator->enterLoop(loopLabel);
+
+            valueNumbering->enterScope();
+            valueNumbering->invalidateReads();
+
             graphGenerator->newBB();
             SgStatement *condStatement = whileStmt->get_condition();
             SgExprStatement *condExprStatement = isSgExprStatement(condStatement);
@@ -263,6 +337,7 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
 
             // get any pragmas in this bb and apply them
             pragmaParser->parsePragmas(bb);
+            recordLoopPragmas(loopID, bb);
 
             if (pragmaParser->getUnrollFactor().first > 1) {
                 PragmaNode *pragma = new UnrollPragmaNode(pragmaParser->getUnrollFactor().first);
@@ -270,6 +345,9 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             }
 
             graphGenerator->newBB();
+            if (graphGenerator->loops[loopID].dataflow) {
+                pendingDataflowRegion = graphGenerator->addDataflowRegion(loopID);
+            }
             // handle the body of the for loop
             handleBB(bb->getStatementList());
 
@@ -280,6 +358,9 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             // and then mark the branch node as the predecessor
             new LoopBackEdge(preLoopEdge, branchNode);
 
+            valueNumbering->exitScope();
+            graphGenerator->exitLoop();
+
             // unapply any pragmas from this bb
             pragmaParser->unstackPragmas();
 
@@ -310,6 +391,8 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
             graphGenerator->newBB();
 
             ifStatementBreaks.push(false);
+            // neither body dominates the code after the if statement
+            valueNumbering->enterScope();
             if (SgBasicBlock *bb = isSgBasicBlock(ifStmt->get_true_body())) {
                 // handle if body
                 handleBB(bb->getStatementList());
@@ -318,6 +401,7 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
                 statements.push_back(ifStmt->get_true_body());
                 handleBB(statements);
             }
+            valueNumbering->exitScope();
 
             bool trueBodyBroke = ifStatementBreaks.top();
             ifStatementBreaks.pop();
@@ -338,6 +422,7 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
 
                 // handle else body
                 graphGenerator->newBB();
+                valueNumbering->enterScope();
                 if (SgBasicBlock *bb = isSgBasicBlock(ifStmt->get_false_body())) {
                     handleBB(bb->getStatementList());
                 } else {
@@ -345,6 +430,7 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
                     statements.push_back(ifStmt->get_false_body());
                     handleBB(statements);
                 }
+                valueNumbering->exitScope();
 
                 falseBodyBroke = ifStatementBreaks.top();
                 ifStatementBreaks.pop();
@@ -376,6 +462,10 @@ void AstParser::handleBB(std::vector<SgStatement *> statements) {
         }
     }
 
+    if (inStage) {
+        graphGenerator->exitDataflowStage();
+    }
+
     if (numberOfReturnStatements > 1) {
         throw std::runtime_error("A maximum of one return statement per function is supported");
     }
@@ -405,8 +495,11 @@ Node *AstParser::handleFunctionCall(SgFunctionCallExp *funcCall) {
         }
 
         graphGenerator->newBB();
+        // values made in the body don't outlive it, they're made again at the next call site
+        valueNumbering->enterScope();
         // process each line of the function body
         handleBB(funcDec->get_definition()->get_body()->getStatementList());
+        valueNumbering->exitScope();
 
         // when inlined, dataflow edges come from the actual node
         return functionReturn;
@@ -416,6 +509,9 @@ Node *AstParser::handleFunctionCall(SgFunctionCallExp *funcCall) {
         FunctionCallEdge *funcCallEdge = new FunctionCallEdge(funcCallNode, funcDec);
         functionDecsNeeded.push(funcDec);
 
+        // the callee could write to any array it's given or any global
+        valueNumbering->invalidateReads();
+
         if (!decsToCalls.count(funcDec)) {
             decsToCalls[funcDec] = std::vector<FunctionCallNode *>();
         }
@@ -452,6 +548,10 @@ Node *AstParser::readExpression(SgExpression *expr) {
         // get the actual variable
         SgInitializedName *varDec = varRef->get_symbol()->get_declaration();
 
+        if (Node *constant = readConstantVariable(varDec)) {
+            return constant;
+        }
+
         // get the pointer/memory element
         Node *variableNode = variableMapper->readVariable(varDec);
 
@@ -460,6 +560,11 @@ Node *AstParser::readExpression(SgExpression *expr) {
             return variableNode;
         }
 
+        ValueNumbering::Key key = valueNumbering->makeKey("Read", {variableNode});
+        if (Node *read = valueNumbering->find(key)) {
+            return read;
+        }
+
         // if its actually a variable, you need a read node
         Node *read = new ReadNode(variableNode);
 
@@ -469,10 +574,14 @@ Node *AstParser::readExpression(SgExpression *expr) {
         // if mem elements, all reads need an element edge
         new ReadMemoryElementEdge(variableNode, read);
 
+        valueNumbering->insert(key, read, {variableNode});
         return read;
 
         // if its an array indexing
     } else if (SgPntrArrRefExp *arrayIndex = isSgPntrArrRefExp(expr)) {
+        if (Node *constant = readConstantElement(arrayIndex)) {
+            return constant;
+        }
 
         // see if derefence has happened before in this BB
         // if yes, returns the already existing deref node
@@ -481,6 +590,12 @@ Node *AstParser::readExpression(SgExpression *expr) {
         DerefNode *deref = getDerefNode(arrayIndex);
 
         Node *memoryElement = deref->memoryElement;
+
+        ValueNumbering::Key key = valueNumbering->makeKey("Read", {memoryElement, deref});
+        if (Node *read = valueNumbering->find(key)) {
+            return read;
+        }
+
         // resolved edge must be added before read
         // as we must specify read address before we can read
         // so we write destination as nullptr
@@ -506,6 +621,8 @@ Node *AstParser::readExpression(SgExpression *expr) {
         // if mem elements, all reads need an element edge
         new ReadMemoryElementEdge(memoryElement, readDataNode);
 
+        valueNumbering->insert(key, readDataNode, {memoryElement});
+
         // the read data node provides the out-going data
         // from all of this
         return readDataNode;
@@ -544,6 +661,52 @@ Node *AstParser::readExpression(SgExpression *expr) {
         // so its in a function for reuse
         Node *arithmeticNode = readArithmeticExpression(expr);
         return arithmeticNode;
+        // comparisons used as values, conditions go through handleConditional
+    } else if (Utils::isComparisonOp(expr->variantT())) {
+        SgBinaryOp *compOp = isSgBinaryOp(expr);
+        Node *lhs = readExpression(compOp->get_lhs_operand());
+        Node *rhs = readExpression(compOp->get_rhs_operand());
+
+        if (Node *constant = constantFolder->foldBinary(expr->variantT(), lhs, rhs)) {
+            return constant;
+        }
+
+        bool commutative = expr->variantT() == V_SgEqualityOp || expr->variantT() == V_SgNotEqualOp;
+        ValueNumbering::Key key =
+            valueNumbering->makeKey("Comparison " + std::to_string(expr->variantT()), {lhs, rhs}, commutative);
+        if (Node *comparison = valueNumbering->find(key)) {
+            return comparison;
+        }
+
+        ComparisonNode *comparisonNode = new ComparisonNode();
+        comparisonNode->binaryComp = true;
+        comparisonNode->lhs = lhs;
+        comparisonNode->rhs = rhs;
+
+        ArithmeticUnitEdge *edge = new ArithmeticUnitEdge(lhs, rhs, comparisonNode);
+        comparisonNode->edge = edge;
+
+        new ControlFlowEdge(comparisonNode);
+        valueNumbering->insert(key, comparisonNode);
+        return comparisonNode;
+    } else if (SgNotOp *notOp = isSgNotOp(expr)) {
+        Node *input = readExpression(notOp->get_operand());
+
+        if (Node *constant = constantFolder->foldUnary(V_SgNotOp, input)) {
+            return constant;
+        }
+
+        ValueNumbering::Key key = valueNumbering->makeKey("Not", {input});
+        if (Node *existing = valueNumbering->find(key)) {
+            return existing;
+        }
+
+        Node *node = new UnaryOpNode("Not");
+        node->setType(input->getType());
+        new DataFlowEdge(input, node);
+        new ControlFlowEdge(node);
+        valueNumbering->insert(key, node);
+        return node;
         // if its a function call
     } else if (SgFunctionCallExp *funcCall = isSgFunctionCallExp(expr)) {
         // function calls can be statements or expressions
@@ -600,7 +763,9 @@ Node *AstParser::readExpression(SgExpression *expr) {
 
         Node *input = readExpression(castExpr->get_operand());
 
-        if (input->getVariant() == NodeVariant::CONSTANT) {
+        if (Node *constant = constantFolder->foldCast(input, type)) {
+            return constant;
+        } else if (input->getVariant() == NodeVariant::CONSTANT) {
             input->setType(type);
             return input;
         } else {
@@ -645,8 +810,8 @@ Node *AstParser::readExpression(SgExpression *expr) {
         return readExpression(commaExpr->get_rhs_operand());
     } else if (auto minusExpr = isSgMinusOp(expr)) {
         Node *input = readExpression(minusExpr->get_operand());
-        if (input->getVariant() == NodeVariant::CONSTANT) {
-            return input;
+        if (Node *constant = constantFolder->foldUnary(V_SgMinusOp, input)) {
+            return constant;
         }
         if (input->getType().dataType == DataType::FLOAT) {
             Node *node = new FNegNode();
@@ -654,7 +819,11 @@ Node *AstParser::readExpression(SgExpression *expr) {
             new ControlFlowEdge(node);
             return node;
         } else {
-            return input;
+            // integers are negated as 0 - x, like LLVM does
+            Node *zero = new ConstantNode("0", input->getType());
+            Node *node = processArithmeticExpression(V_SgSubtractOp, zero, input);
+            new ControlFlowEdge(node);
+            return node;
         }
 
     } else if (auto sizeOfExpr = isSgSizeOfOp(expr)) {
@@ -716,6 +885,13 @@ Node *AstParser::readExpression(SgExpression *expr) {
     } else if (auto selectOp = isSgConditionalExp(expr)) {
         Node *condition = readExpression(selectOp->get_conditional_exp());
 
+        // only the side that's taken is built
+        double value;
+        if (constantFolder->getValue(condition, value)) {
+            constantFolder->remove(condition);
+            return readExpression(value != 0 ? selectOp->get_true_exp() : selectOp->get_false_exp());
+        }
+
         Node *pred = condition;
         if (condition->getVariant() != NodeVariant::COMPARISON) {
             // there's actually a few types of nodes here to
@@ -737,7 +913,9 @@ Node *AstParser::readExpression(SgExpression *expr) {
         new ControlFlowEdge(branch);
         new DataFlowEdge(pred, branch);
 
+        valueNumbering->enterScope();
         Node *a = readExpression(selectOp->get_true_exp());
+        valueNumbering->exitScope();
 
         new ProgramlBranchEdge();
 
@@ -745,7 +923,9 @@ Node *AstParser::readExpression(SgExpression *expr) {
 
         new RevertControlFlowEdge(branch);
 
+        valueNumbering->enterScope();
         Node *b = readExpression(selectOp->get_false_exp());
+        valueNumbering->exitScope();
 
         new ProgramlBranchEdge();
 
@@ -830,7 +1010,7 @@ void AstParser::handleConditional(SgExpression *expr, Node *&branchNodeOut, Node
 DerefNode *AstParser::getDerefNode(SgBinaryOp *arrayIndex) {
     DerefNode *deref = nullptr;
 
-    if (!(deref = derefTracker->getDerefNode(arrayIndex))) {
+    if (!(deref = findDerefNode(arrayIndex))) {
         SgExpression *lhs = arrayIndex->get_lhs_operand();
 
         if (SgPntrArrRefExp *prevDerefExpr = isSgPntrArrRefExp(lhs)){
@@ -838,6 +1018,8 @@ DerefNode *AstParser::getDerefNode(SgBinaryOp *arrayIndex) {
                 Node *rhs = readExpression(arrayIndex->get_rhs_operand());
                 DerefNode *deref = getDerefNode(prevDerefExpr);
                 new DataFlowEdge(rhs, deref);
+                // the deref is shared with the outer dimensions, so give it the full index
+                deref->indices = getAffineIndices(arrayIndex);
                 return deref;
             }
         } 
@@ -846,6 +1028,7 @@ DerefNode *AstParser::getDerefNode(SgBinaryOp *arrayIndex) {
         // add a node for the address calculation
         deref = new DerefNode();
         derefTracker->saveDerefNode(arrayIndex, deref);
+        valueNumbering->insertDeref(arrayIndex, deref, getIndexVariables(arrayIndex));
 
 
 
@@ -895,11 +1078,39 @@ DerefNode *AstParser::getDerefNode(SgBinaryOp *arrayIndex) {
 
         new SextDataFlowEdge(rhs, deref);
         new ControlFlowEdge(deref);
+
+        deref->indices = getAffineIndices(arrayIndex);
     }
 
     return deref;
 }
 
+// with value numbering, addresses are shared across BBs until their index changes,
+// otherwise only inside a BB
+DerefNode *AstParser::findDerefNode(SgBinaryOp *arrayIndex) {
+    if (valueNumbering->enabled) {
+        return valueNumbering->findDeref(arrayIndex);
+    }
+    return derefTracker->getDerefNode(arrayIndex);
+}
+
+// the variables read by the indices of an array access, not the array itself
+std::set<Node *> AstParser::getIndexVariables(SgBinaryOp *arrayIndex) {
+    std::set<Node *> variables;
+    SgExpression *expr = arrayIndex;
+    while (SgPntrArrRefExp *pntrArrRef = isSgPntrArrRefExp(expr)) {
+        for (SgNode *node : NodeQuery::querySubTree(pntrArrRef->get_rhs_operand(), V_SgVarRefExp)) {
+            SgInitializedName *varDec = isSgVarRefExp(node)->get_symbol()->get_declaration();
+            SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+            if (variableMapper->variableToReadNode.count(underlyingVariable)) {
+                variables.insert(variableMapper->variableToReadNode[underlyingVariable]);
+            }
+        }
+        expr = pntrArrRef->get_lhs_operand();
+    }
+    return variables;
+}
+
 DerefNode *AstParser::getDotNode(SgBinaryOp *binaryOp) {
 
     SgExpression *rhsOp = binaryOp->get_rhs_operand();
@@ -940,53 +1151,111 @@ DerefNode *AstParser::getDotNode(SgBinaryOp *binaryOp) {
     return accessNode;
 }
 
-Node *evaluateConstantArithmetic(SgExpression *expr, Node *lhs, Node *rhs) {
-    std::string stringOp = Utils::getArithmeticNodeEncoding(expr->variantT());
-    ConstantNode *lhsConstant = dynamic_cast<ConstantNode *>(lhs);
-    ConstantNode *rhsConstant = dynamic_cast<ConstantNode *>(rhs);
-
-    lhsConstant->folded = true;
-    rhsConstant->folded = true;
-
-    double a = lhsConstant->getValue();
-    double b = rhsConstant->getValue();
-    std::string stringResult;
-    if (stringOp == "Multiplication") {
-        double result = a * b;
-        std::cerr << "folding:" << std::endl;
-        std::cerr << a << "*" << b << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else if (stringOp == "Addition") {
-        double result = a + b;
-        std::cerr << "folding:" << std::endl;
-        std::cerr << a << "+" << b << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else if (stringOp == "Subtraction") {
-        double result = a - b;
-        std::cerr << "folding:" << std::endl;
-        std::cerr << a << "-" << b << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else if (stringOp == "Division") {
-        double result = a / b;
-        std::cerr << "folding:" << std::endl;
-        std::cerr << a << "/" << b << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else if (stringOp == "LeftShift") {
-        double result = int(a) << int(b);
-        std::cerr << "folding:" << std::endl;
-        std::cerr << int(a) << "<<" << int(b) << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else if (stringOp == "RightShift") {
-        double result = int(a) >> int(b);
-        std::cerr << "folding:" << std::endl;
-        std::cerr << int(a) << ">>" << int(b) << "=" << result << std::endl;
-        stringResult = std::to_string(result);
-    } else {
-        throw std::runtime_error("Found unexpected arithmetic encoding: " + stringOp);
+// const ints and floats with an initializer, pointers and arrays aren't scalars
+bool AstParser::isConstantScalar(SgInitializedName *varDec) {
+    SgType *type = varDec->get_type();
+    SgType *strippedType = type->stripTypedefsAndModifiers();
+    if (isSgArrayType(strippedType) || isSgPointerType(strippedType) || isSgClassType(strippedType)) {
+        return false;
     }
+    bool isConst = type->unparseToString().find("const") != std::string::npos;
+    return isConst && isSgAssignInitializer(varDec->get_initptr());
+}
 
-    Node *node = new ConstantNode(stringResult, lhsConstant->getType());
-    return node;
+// remember the value of a const scalar, taking the constant out of the graph
+// false if the value isn't a constant
+bool AstParser::setConstantValue(SgInitializedName *varDec, Node *value) {
+    double unused;
+    if (!constantFolder->getValue(value, unused)) {
+        return false;
+    }
+    std::string type = varDec->get_type()->findBaseType()->unparseToString();
+    Node *constant = constantFolder->foldCast(value, type);
+    if (!constant) {
+        constant = value;
+    }
+    ConstantNode *typedConstant = dynamic_cast<ConstantNode *>(constant);
+    variableMapper->constantValues[varDec] = std::make_pair(typedConstant->value, typedConstant->getType());
+    constantFolder->remove(constant);
+    return true;
+}
+
+// the value and type of a const scalar, nullptr if it isn't known
+std::pair<std::string, TypeStruct> *AstParser::getConstantValue(SgInitializedName *varDec) {
+    SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+
+    // globals are only looked at when they're used
+    bool isGlobal = isSgGlobal(underlyingVariable->get_scope());
+    if (isGlobal && !variableMapper->constantValues.count(underlyingVariable) && isConstantScalar(underlyingVariable)) {
+        SgAssignInitializer *init = isSgAssignInitializer(underlyingVariable->get_initptr());
+        Node *value = readExpression(init->get_operand());
+        if (!setConstantValue(underlyingVariable, value)) {
+            throw std::runtime_error("Global constant isn't initialized with a constant: " +
+                                     underlyingVariable->unparseToString());
+        }
+    }
+
+    if (variableMapper->constantValues.count(underlyingVariable)) {
+        return &variableMapper->constantValues[underlyingVariable];
+    }
+    return nullptr;
+}
+
+Node *AstParser::readConstantVariable(SgInitializedName *varDec) {
+    if (std::pair<std::string, TypeStruct> *value = getConstantValue(varDec)) {
+        return new ConstantNode(value->first, value->second);
+    }
+    return nullptr;
+}
+
+// an element of a const array with an initializer, at constant indices
+Node *AstParser::readConstantElement(SgPntrArrRefExp *arrayIndex) {
+    SgExpression *base = arrayIndex;
+    while (SgPntrArrRefExp *pntrArrRef = isSgPntrArrRefExp(base)) {
+        base = pntrArrRef->get_lhs_operand();
+    }
+    SgVarRefExp *varRef = isSgVarRefExp(base);
+    if (!varRef) {
+        return nullptr;
+    }
+    SgInitializedName *array = variableMapper->getUnderlyingVariable(varRef->get_symbol()->get_declaration());
+    bool isConst = array->get_type()->unparseToString().find("const") != std::string::npos;
+    if (!isConst || !isSgAggregateInitializer(array->get_initptr())) {
+        return nullptr;
+    }
+
+    // walk down the nested initializer lists, one per dimension
+    SgExpression *element = array->get_initptr();
+    for (AffineIndex &index : getAffineIndices(arrayIndex)) {
+        SgAggregateInitializer *aggregate = isSgAggregateInitializer(element);
+        if (!aggregate || !index.affine || !index.coefficients.empty()) {
+            return nullptr;
+        }
+        SgExpressionPtrList &elements = aggregate->get_initializers()->get_expressions();
+        if (index.constant < 0 || index.constant >= elements.size()) {
+            return nullptr;
+        }
+        element = elements[index.constant];
+    }
+
+    SgAssignInitializer *init = isSgAssignInitializer(element);
+    if (!init) {
+        return nullptr;
+    }
+    // only literals readExpression knows, so reading the initializer can't add anything but a constant
+    SgExpression *literal = init->get_operand();
+    while (isSgCastExp(literal) || isSgMinusOp(literal)) {
+        literal = isSgUnaryOp(literal)->get_operand();
+    }
+    if (!isSgIntVal(literal) && !isSgLongLongIntVal(literal) && !isSgBoolValExp(literal) && !isSgDoubleVal(literal)) {
+        return nullptr;
+    }
+    Node *value = readExpression(init->get_operand());
+    std::string type = array->get_type()->findBaseType()->unparseToString();
+    if (Node *constant = constantFolder->foldCast(value, type)) {
+        return constant;
+    }
+    return value;
 }
 
 Node *AstParser::readArithmeticExpression(SgExpression *expr) {
@@ -996,13 +1265,32 @@ Node *AstParser::readArithmeticExpression(SgExpression *expr) {
         Node *lhs = readExpression(binaryOp->get_lhs_operand());
         Node *rhs = readExpression(binaryOp->get_rhs_operand());
 
-        if (lhs->getVariant() == NodeVariant::CONSTANT && rhs->getVariant() == NodeVariant::CONSTANT) {
-            return evaluateConstantArithmetic(expr, lhs, rhs);
+        // update ops write back to a variable, so they're never folded
+        if (!Utils::isUpdateOp(expr->variantT())) {
+            if (Node *constant = constantFolder->foldBinary(expr->variantT(), lhs, rhs)) {
+                return constant;
+            }
         }
 
         try {
-            node = processArithmeticExpression(binaryOp->variantT(), lhs, rhs);
+            VariantT variant = binaryOp->variantT();
+            std::string encoding = Utils::getArithmeticNodeEncoding(variant);
+            bool commutative = encoding == "Addition" || encoding == "Multiplication" || encoding == "BitAnd" ||
+                               encoding == "BitXor" || encoding == "Or" || encoding == "Xor";
+            ValueNumbering::Key key = valueNumbering->makeKey(encoding, {lhs, rhs}, commutative);
+            if (Node *existing = valueNumbering->find(key)) {
+                // the equivalent node has its own copies of any constants
+                for (Node *operand : {lhs, rhs}) {
+                    if (operand->getVariant() == NodeVariant::CONSTANT) {
+                        constantFolder->remove(operand);
+                    }
+                }
+                return existing;
+            }
+
+            node = processArithmeticExpression(variant, lhs, rhs);
             new ControlFlowEdge(node);
+            valueNumbering->insert(key, node);
         } catch (std::runtime_error e) {
             std::cout << e.what() + binaryOp->unparseToString() << std::endl;
         }
@@ -1023,6 +1311,9 @@ Node *AstParser::processArithmeticExpression(VariantT variant, Node *lhs, Node *
 
 Node *AstParser::addWrite(Node *variable, Node *rhs, Node *typeDependency) {
     assert(typeDependency);
+    // earlier reads of the variable are out of date
+    valueNumbering->invalidate(variable);
+
     WriteNode *writeNode = new WriteNode(typeDependency);
 
     Edge *dataflowEdge = new ImplicitCastDataFlowEdge(rhs, writeNode);
@@ -1072,6 +1363,7 @@ Node *AstParser::writeExpression(SgNode *lhs, Node *rhs) {
         assert(varDec);
 
         Node *variable = variableMapper->writeVariable(varDec);
+        valueNumbering->invalidate(variable);
 
         TypeStruct pointerTypeDesc = TypeStruct(DataType::INTEGER, 64);
         ConstantNode *fakeConstant = new ConstantNode("0", pointerTypeDesc);
@@ -1111,6 +1403,8 @@ ReturnEdge *AstParser::handleFuncDec(SgFunctionDeclaration *funcDec, Node *exter
     startEdge->functionName = funcDec->get_name();
     functionStartEdgeMap[funcDec] = startEdge;
 
+    valueNumbering->enterFunction();
+
     // add possible return node
     ReturnEdge *functionReturnEdge;
 
@@ -1125,6 +1419,12 @@ ReturnEdge *AstParser::handleFuncDec(SgFunctionDeclaration *funcDec, Node *exter
             new ParameterInitializeEdge(parameter);
         }
 
+        if (pragmaParser->getDataflow()) {
+            pendingDataflowRegion = graphGenerator->addDataflowRegion(-1);
+        }
+        if (pragmaParser->getLoopMerge()) {
+            graphGenerator->loopMergeFunctions.insert(funcDec);
+        }
         handleBB(bb->getStatementList());
 
         // add possible return node
@@ -1136,9 +1436,134 @@ ReturnEdge *AstParser::handleFuncDec(SgFunctionDeclaration *funcDec, Node *exter
 
     new ControlFlowEdge(external);
 
+    valueNumbering->exitFunction();
     return functionReturnEdge;
 }
 
+void AstParser::recordLoopPragmas(int loopID, SgBasicBlock *body) {
+    LoopInfo &loop = graphGenerator->loops[loopID];
+    loop.unrollFactor = pragmaParser->getLoopUnrollFactor();
+    loop.pragmaTripcount = pragmaParser->getLoopTripcount();
+    loop.pipelined = pragmaParser->getLoopPipelined();
+    loop.targetII = pragmaParser->getLoopTargetII();
+    loop.rewind = pragmaParser->getLoopRewind();
+    loop.flatten = pragmaParser->getLoopFlatten();
+    loop.merge = pragmaParser->getLoopMerge();
+    loop.dataflow = pragmaParser->getDataflow();
+
+    // labels and pragmas don't stop a body being only the loop inside it
+    int statements = 0;
+    bool onlyLoops = true;
+    for (SgStatement *statement : body->getStatementList()) {
+        if (isSgPragmaDeclaration(statement)) {
+            continue;
+        }
+        if (SgLabelStatement *labelStatement = isSgLabelStatement(statement)) {
+            if (!labelStatement->get_statement()) {
+                continue;
+            }
+            statement = labelStatement->get_statement();
+        }
+        statements++;
+        onlyLoops = onlyLoops && (isSgForStatement(statement) || isSgWhileStmt(statement));
+    }
+    loop.perfectBody = statements == 1 && onlyLoops;
+}
+
+// the loop whose iterator a variable is, searching out from the current loop
+// -1 if it isn't the iterator of any loop we're in
+int AstParser::getIteratorLoop(SgInitializedName *varDec) {
+    SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+    if (!variableMapper->variableToReadNode.count(underlyingVariable)) {
+        return -1;
+    }
+    Node *variable = variableMapper->variableToReadNode[underlyingVariable];
+
+    for (int loopID = graphGenerator->getLoopID(); loopID != -1; loopID = graphGenerator->loops[loopID].parent) {
+        if (graphGenerator->loops[loopID].iterator == variable) {
+            return loopID;
+        }
+    }
+    return -1;
+}
+
+AffineIndex AstParser::getAffineIndex(SgExpression *expr) {
+    AffineIndex index;
+
+    if (SgIntVal *intVal = isSgIntVal(expr)) {
+        index.constant = intVal->get_value();
+    } else if (SgLongLongIntVal *intVal = isSgLongLongIntVal(expr)) {
+        index.constant = intVal->get_value();
+    } else if (SgCastExp *castExpr = isSgCastExp(expr)) {
+        index = getAffineIndex(castExpr->get_operand());
+    } else if (SgMinusOp *minusOp = isSgMinusOp(expr)) {
+        index = getAffineIndex(minusOp->get_operand());
+        index.constant = -index.constant;
+        for (std::pair<const int, long> &coefficient : index.coefficients) {
+            coefficient.second = -coefficient.second;
+        }
+    } else if (SgVarRefExp *varRef = isSgVarRefExp(expr)) {
+        SgInitializedName *varDec = varRef->get_symbol()->get_declaration();
+        int loopID = getIteratorLoop(varDec);
+        if (std::pair<std::string, TypeStruct> *value = getConstantValue(varDec)) {
+            index.affine = value->second.dataType == DataType::INTEGER && value->second.bitwidth > 1;
+            index.constant = index.affine ? std::stol(value->first) : 0;
+        } else if (loopID == -1) {
+            index.affine = false;
+        } else {
+            index.coefficients[loopID] = 1;
+        }
+    } else if (isSgAddOp(expr) || isSgSubtractOp(expr)) {
+        SgBinaryOp *binaryOp = isSgBinaryOp(expr);
+        AffineIndex lhs = getAffineIndex(binaryOp->get_lhs_operand());
+        AffineIndex rhs = getAffineIndex(binaryOp->get_rhs_operand());
+        long sign = isSgAddOp(expr) ? 1 : -1;
+
+        index = lhs;
+        index.affine = lhs.affine && rhs.affine;
+        index.constant += sign * rhs.constant;
+        for (std::pair<const int, long> &coefficient : rhs.coefficients) {
+            index.coefficients[coefficient.first] += sign * coefficient.second;
+        }
+    } else if (isSgMultiplyOp(expr) || isSgLshiftOp(expr)) {
+        SgBinaryOp *binaryOp = isSgBinaryOp(expr);
+        AffineIndex lhs = getAffineIndex(binaryOp->get_lhs_operand());
+        AffineIndex rhs = getAffineIndex(binaryOp->get_rhs_operand());
+
+        // one side has to be a constant for the product to stay affine
+        long scale;
+        bool validShift = !isSgLshiftOp(expr) || (rhs.constant >= 0 && rhs.constant < 32);
+        if (rhs.affine && rhs.coefficients.empty() && validShift) {
+            scale = isSgLshiftOp(expr) ? (1L << rhs.constant) : rhs.constant;
+            index = lhs;
+        } else if (lhs.affine && lhs.coefficients.empty() && isSgMultiplyOp(expr)) {
+            scale = lhs.constant;
+            index = rhs;
+        } else {
+            index.affine = false;
+            return index;
+        }
+        index.constant *= scale;
+        for (std::pair<const int, long> &coefficient : index.coefficients) {
+            coefficient.second *= scale;
+        }
+    } else {
+        index.affine = false;
+    }
+    return index;
+}
+
+// a[i][j] is (a[i])[j], so walk down the lhs and reverse to get the outermost first
+std::vector<AffineIndex> AstParser::getAffineIndices(SgBinaryOp *arrayIndex) {
+    std::vector<AffineIndex> indices;
+    SgExpression *expr = arrayIndex;
+    while (SgPntrArrRefExp *pntrArrRef = isSgPntrArrRefExp(expr)) {
+        indices.insert(indices.begin(), getAffineIndex(pntrArrRef->get_rhs_operand()));
+        expr = pntrArrRef->get_lhs_operand();
+    }
+    return indices;
+}
+
 LocalScalarNode *AstParser::getIteratorFromForInit(SgStatementPtrList statements) {
     if (statements.size() > 1) {
         throw std::runtime_error("More than 1 statement in for statement init");
@@ -1204,7 +1629,7 @@ ReturnEdge *AstParser::getFunctionReturnEdge(SgFunctionDeclaration *funcDec) {
 }
 
 void AstParser::parseAst(SgFunctionDefinition *topLevelFuncDef) {
-    SgFunctionDeclaration *topLevelFuncDec = topLevelFuncDef->get_declaration();
+    topLevelFuncDec = topLevelFuncDef->get_declaration();
     graphGenerator->setGroupName("External");
     graphGenerator->setFuncDec(topLevelFuncDec);
     Node *external = new ExternalNode(graphGenerator);
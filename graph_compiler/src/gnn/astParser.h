@@ -13,6 +13,8 @@ class GraphGenerator;
 class DerefTracker;
 class PragmaParser;
 class VariableMapper;
+class ConstantFolder;
+class ValueNumbering;
 class LocalScalarNode;
 class ControlFlowEdge;
 
@@ -34,8 +36,11 @@ class AstParser {
     PragmaParser *pragmaParser;
     VariableMapper *variableMapper;
     DerefTracker *derefTracker;
+    ConstantFolder *constantFolder;
+    ValueNumbering *valueNumbering;
 
     void parseAst(SgFunctionDefinition *topLevelFuncDef);
+    SgFunctionDeclaration *topLevelFuncDec = nullptr;
 
     void handleBB(std::vector<SgStatement *> statements);
     void catchBreakStatements();
@@ -64,10 +69,25 @@ class AstParser {
     ReturnEdge *handleFuncDec(SgFunctionDeclaration *funcDec, Node *external);
 
     DerefNode *getDerefNode(SgBinaryOp *arrayIndex);
+    DerefNode *findDerefNode(SgBinaryOp *arrayIndex);
+    std::set<Node *> getIndexVariables(SgBinaryOp *arrayIndex);
+
+    // const scalars and elements of const arrays with known values are read as constants,
+    // these return nullptr when the value isn't known
+    Node *readConstantVariable(SgInitializedName *varDec);
+    std::pair<std::string, TypeStruct> *getConstantValue(SgInitializedName *varDec);
+    Node *readConstantElement(SgPntrArrRefExp *arrayIndex);
+    bool isConstantScalar(SgInitializedName *varDec);
+    bool setConstantValue(SgInitializedName *varDec, Node *value);
     bool isUpdateOp = false;
 
     DerefNode *getDotNode(SgBinaryOp *dotExpr);
 
+    // summarise array indices as affine functions of the enclosing loop iterators
+    std::vector<AffineIndex> getAffineIndices(SgBinaryOp *arrayIndex);
+    AffineIndex getAffineIndex(SgExpression *expr);
+    int getIteratorLoop(SgInitializedName *varDec);
+
     FunctionStartEdge *getFunctionStartEdge(SgFunctionDeclaration *funcDec);
     ReturnEdge *getFunctionReturnEdge(SgFunctionDeclaration *funcDec);
 
@@ -82,6 +102,12 @@ class AstParser {
     std::set<SgInitializedName *> variableDeclarationsProcessed;
 
     Node *functionReturn = nullptr;
+
+    // label of the next loop, if the statement before it was a label
+    std::string pendingLoopLabel;
+    // the dataflow region the next handleBB call is the body of, -1 if it isn't one
+    int pendingDataflowRegion = -1;
+    void recordLoopPragmas(int loopID, SgBasicBlock *body);
 };
 } // namespace GNN
 
@@ -0,0 +1,277 @@
+#include "bankConflictAnalysis.h"
+#include "analysisUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace {
+
+// past this many copies of one access, don't enumerate them
+const double MAX_COPIES = 4096;
+
+} // namespace
+
+namespace GNN {
+
+BankConflictAnalysis::BankConflictAnalysis(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    predecessors = Analysis::getDataflowPredecessors(graphGenerator);
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+}
+
+// accesses share ports within an iteration of the outermost pipelined loop they're in,
+// or of their own loop if they aren't pipelined
+int BankConflictAnalysis::getRegion(int loopID) {
+    int region = loopID;
+    for (int parent = loopID; parent != -1; parent = graphGenerator->loops[parent].parent) {
+        if (graphGenerator->loops[parent].pipelined) {
+            region = parent;
+        }
+    }
+    return region;
+}
+
+// the values each enclosing iterator takes in one iteration of the region
+// loops inside a pipeline take every value, unrolled loops take one per copy
+std::map<int, int> BankConflictAnalysis::getCopiesPerLoop(Node *access, int region) {
+    std::map<int, int> copies;
+    bool insideRegion = graphGenerator->loops[region].pipelined;
+    for (int loopID = access->loopID; loopID != -1; loopID = graphGenerator->loops[loopID].parent) {
+        LoopInfo &loop = graphGenerator->loops[loopID];
+        if (loopID == region) {
+            insideRegion = false;
+        }
+        if (insideRegion) {
+            copies[loopID] = std::max(1, int(std::ceil(loop.getTripcount())));
+        } else {
+            copies[loopID] = std::max(1, loop.unrollFactor);
+        }
+    }
+    return copies;
+}
+
+// iterators not given are at their first value
+long BankConflictAnalysis::getIndexValue(AffineIndex &index, std::map<int, long> &iterators) {
+    long value = index.constant;
+    for (std::pair<const int, long> &coefficient : index.coefficients) {
+        long iterator = iterators.count(coefficient.first) ? iterators[coefficient.first]
+                                                           : graphGenerator->loops[coefficient.first].getLowerBound();
+        value += coefficient.second * iterator;
+    }
+    return value;
+}
+
+// the bank of each partitioned dimension an index lands in
+std::vector<long> BankConflictAnalysis::getBank(Node *array, std::vector<AffineIndex> &indices,
+                                                std::map<int, long> &iterators) {
+    std::vector<int> dimensions = Analysis::getArrayDimensions(array);
+    std::string types[2] = {array->partitionType1, array->partitionType2};
+    int factors[2] = {array->partitionFactor1, array->partitionFactor2};
+
+    std::vector<long> bank;
+    for (int i = 0; i < 2 && i < indices.size(); i++) {
+        long value = getIndexValue(indices[i], iterators);
+        if (types[i] == "complete") {
+            bank.push_back(value);
+        } else if (types[i] == "cyclic" && factors[i] > 1) {
+            bank.push_back(((value % factors[i]) + factors[i]) % factors[i]);
+        } else if (types[i] == "block" && factors[i] > 1 && i < dimensions.size()) {
+            long blockSize = std::max(1L, long(std::ceil(double(dimensions[i]) / factors[i])));
+            bank.push_back(value / blockSize);
+        } else {
+            bank.push_back(0);
+        }
+    }
+    return bank;
+}
+
+// the word of a reshaped array an index is packed into
+// cyclic reshaping packs neighbouring elements together, block reshaping packs elements a block apart
+std::vector<long> BankConflictAnalysis::getWord(Node *array, std::vector<AffineIndex> &indices,
+                                                std::map<int, long> &iterators) {
+    std::vector<int> dimensions = Analysis::getArrayDimensions(array);
+    int factor = std::max(1, array->reshapeFactor);
+
+    std::vector<long> word;
+    for (int i = 0; i < indices.size(); i++) {
+        long value = getIndexValue(indices[i], iterators);
+        if (i == array->reshapeDim - 1) {
+            if (array->reshapeType == "complete") {
+                value = 0;
+            } else if (array->reshapeType == "cyclic") {
+                value /= factor;
+            } else if (array->reshapeType == "block" && i < dimensions.size()) {
+                value %= std::max(1L, long(std::ceil(double(dimensions[i]) / factor)));
+            }
+        }
+        word.push_back(value);
+    }
+    return word;
+}
+
+BankConflictAnalysis::Contention BankConflictAnalysis::getContention(Node *array, std::vector<Node *> &accesses,
+                                                                     int region) {
+    Contention contention;
+    std::map<std::vector<long>, double> bankAccesses;
+    // accesses to the same word of a reshaped array are a single access
+    std::set<std::vector<long>> accessedWords;
+
+    for (Node *access : accesses) {
+        std::map<int, int> copiesPerLoop = getCopiesPerLoop(access, region);
+        double copies = 1;
+        for (std::pair<const int, int> &loopCopies : copiesPerLoop) {
+            copies *= loopCopies.second;
+        }
+        contention.accesses += copies;
+
+        DerefNode *address = Analysis::getAddress(predecessors, access);
+        if (!address || !address->isAffine() || copies > MAX_COPIES) {
+            contention.unplaced += copies;
+            unplacedAccesses.insert(access);
+            continue;
+        }
+
+        // count through every combination of iterator values, like an odometer
+        std::vector<std::pair<int, int>> loops(copiesPerLoop.begin(), copiesPerLoop.end());
+        std::vector<int> counters(loops.size(), 0);
+        while (true) {
+            std::map<int, long> iterators;
+            for (int i = 0; i < loops.size(); i++) {
+                iterators[loops[i].first] = graphGenerator->loops[loops[i].first].getLowerBound() + counters[i];
+            }
+            std::vector<long> bank = getBank(array, address->indices, iterators);
+            accessBanks[access].insert(bank);
+            if (array->reshapeType == "none") {
+                bankAccesses[bank]++;
+            } else {
+                std::vector<long> word = getWord(array, address->indices, iterators);
+                word.insert(word.begin(), bank.begin(), bank.end());
+                if (accessedWords.insert(word).second) {
+                    bankAccesses[bank]++;
+                }
+            }
+
+            int i = 0;
+            while (i < loops.size() && ++counters[i] == loops[i].second) {
+                counters[i] = 0;
+                i++;
+            }
+            if (i == loops.size()) {
+                break;
+            }
+        }
+    }
+
+    for (std::pair<const std::vector<long>, double> &bank : bankAccesses) {
+        contention.worstBank = std::max(contention.worstBank, bank.second);
+    }
+    // we don't know which bank these go to, so they could all be in the busiest one
+    contention.worstBank += contention.unplaced;
+    contention.cycles = std::max(1.0, std::ceil(contention.worstBank / Analysis::getNumPorts(graphGenerator, array)));
+    return contention;
+}
+
+void BankConflictAnalysis::addMemoryBanks() {
+    VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        Node *access = node.get();
+        if (!memoryElements.count(access) || !variableMapper->arrayBanks.count(memoryElements[access])) {
+            continue;
+        }
+        Node *array = memoryElements[access];
+        DerefNode *address = Analysis::getAddress(predecessors, access);
+
+        std::vector<Node *> banks;
+        if (!address || !address->isAffine() || unplacedAccesses.count(access)) {
+            banks = variableMapper->arrayBanks[array];
+        } else {
+            // accesses outside loops weren't enumerated, they only have the one copy
+            if (!accessBanks.count(access)) {
+                std::map<int, long> iterators;
+                accessBanks[access].insert(getBank(array, address->indices, iterators));
+            }
+            for (std::vector<long> bank : accessBanks[access]) {
+                Node *bankNode = variableMapper->getBankNode(array, bank);
+                if (std::find(banks.begin(), banks.end(), bankNode) == banks.end()) {
+                    banks.push_back(bankNode);
+                }
+            }
+        }
+
+        access->memoryBanks = banks;
+        // an address shared by several accesses reaches all of their banks
+        if (address) {
+            for (Node *bankNode : banks) {
+                if (std::find(address->memoryBanks.begin(), address->memoryBanks.end(), bankNode) ==
+                    address->memoryBanks.end()) {
+                    address->memoryBanks.push_back(bankNode);
+                }
+            }
+        }
+    }
+}
+
+void BankConflictAnalysis::run() {
+    // accesses to each array, grouped by the region they share ports in
+    std::map<int, std::map<Node *, std::vector<Node *>>> regionAccesses;
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (!memoryElements.count(node.get()) || node->loopID == -1) {
+            continue;
+        }
+        Node *array = memoryElements[node.get()];
+        if (Analysis::isScalarElement(array)) {
+            continue;
+        }
+        regionAccesses[getRegion(node->loopID)][array].push_back(node.get());
+    }
+
+    std::map<Node *, double> arrayConflicts;
+    double totalConflicts = 0;
+    for (std::pair<const int, std::map<Node *, std::vector<Node *>>> &region : regionAccesses) {
+        LoopInfo &loop = graphGenerator->loops[region.first];
+        for (std::pair<Node *const, std::vector<Node *>> &arrayAccesses : region.second) {
+            Node *array = arrayAccesses.first;
+            Contention contention = getContention(array, arrayAccesses.second, region.first);
+            loop.bankCycles[array] = contention.cycles;
+
+            int conflicts = int(contention.cycles) - 1;
+            for (Node *access : arrayAccesses.second) {
+                access->bankConflicts = conflicts;
+                if (DerefNode *address = Analysis::getAddress(predecessors, access)) {
+                    address->bankConflicts = conflicts;
+                }
+            }
+            arrayConflicts[array] = std::max(arrayConflicts[array], double(conflicts));
+            totalConflicts += conflicts;
+
+            std::string name = Analysis::getArrayName(array);
+            graphGenerator->addStat("bankConflicts_" + loop.getStatName() + "_" + name, conflicts, false);
+            graphGenerator->addReport(loop.label + ": " + name + " gets " + std::to_string(int(contention.accesses)) +
+                                      " accesses per iteration (" + std::to_string(int(contention.unplaced)) +
+                                      " non-affine) over " + std::to_string(int(Analysis::getNumBanks(array))) +
+                                      " banks, the busiest bank gets " + std::to_string(int(contention.worstBank)) +
+                                      ", " + std::to_string(conflicts) + " conflict cycles");
+            for (Node *access : arrayAccesses.second) {
+                DerefNode *address = Analysis::getAddress(predecessors, access);
+                std::string index;
+                if (address) {
+                    for (AffineIndex &dimension : address->indices) {
+                        index += "[" + dimension.toString() + "]";
+                    }
+                }
+                std::string kind = dynamic_cast<WriteNode *>(access) ? "write " : "read ";
+                graphGenerator->addReport("    " + kind + name + (index.empty() ? "[?]" : index));
+            }
+        }
+    }
+
+    for (std::pair<Node *const, double> &conflicts : arrayConflicts) {
+        graphGenerator->addStat("bankConflicts_" + Analysis::getArrayName(conflicts.first), conflicts.second, false);
+    }
+    graphGenerator->addStat("estBankConflicts", totalConflicts, true);
+
+    if (!graphGenerator->variableMapper->arrayBanks.empty()) {
+        addMemoryBanks();
+    }
+}
+
+} // namespace GNN
@@ -0,0 +1,56 @@
+#ifndef GNN_BANK_CONFLICT_ANALYSIS_H
+#define GNN_BANK_CONFLICT_ANALYSIS_H
+
+#include "graphGenerator.h"
+#include "loopInfo.h"
+#include "node.h"
+#include <map>
+#include <set>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+
+// Counts the accesses each bank of an array gets in the same cycle.
+// The copies of an access the unroll factors make are enumerated, and their affine indices
+// are mapped to banks with the array's partition pragmas. Accesses we can't place could hit any bank,
+// so they are added to the busiest one. Accesses to the same word of a reshaped array only count once.
+// An iteration of a pipelined loop includes the loops inside it, which are fully unrolled.
+// With --bank_nodes, each access is connected to the banks its copies reach, and to every bank if we can't place it.
+class BankConflictAnalysis {
+  public:
+    BankConflictAnalysis(GraphGenerator *graphGenerator);
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, std::vector<Node *>> predecessors;
+    std::map<Node *, Node *> memoryElements;
+
+    // the banks the copies of each access land in, and the accesses we couldn't place
+    std::map<Node *, std::set<std::vector<long>>> accessBanks;
+    std::set<Node *> unplacedAccesses;
+
+    int getRegion(int loopID);
+    std::map<int, int> getCopiesPerLoop(Node *access, int region);
+    long getIndexValue(AffineIndex &index, std::map<int, long> &iterators);
+    std::vector<long> getBank(Node *array, std::vector<AffineIndex> &indices, std::map<int, long> &iterators);
+    std::vector<long> getWord(Node *array, std::vector<AffineIndex> &indices, std::map<int, long> &iterators);
+
+    struct Contention {
+        double accesses = 0;
+        double unplaced = 0;
+        double worstBank = 0;
+        double cycles = 1;
+    };
+    Contention getContention(Node *array, std::vector<Node *> &accesses, int region);
+    void addMemoryBanks();
+};
+
+} // namespace GNN
+
+#endif
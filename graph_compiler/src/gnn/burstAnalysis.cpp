@@ -0,0 +1,146 @@
+#include "burstAnalysis.h"
+#include "analysisUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace GNN {
+
+BurstAnalysis::BurstAnalysis(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    predecessors = Analysis::getDataflowPredecessors(graphGenerator);
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+}
+
+// elements the access goes through in order before it jumps, 1 if every access jumps
+long BurstAnalysis::getSequentialRun(Node *access, DerefNode *address, Node *array) {
+    std::vector<int> dimensions = Analysis::getArrayDimensions(array);
+    std::vector<AffineIndex> &indices = address->indices;
+    if (!address->isAffine() || indices.empty() || indices.size() > dimensions.size()) {
+        return 1;
+    }
+
+    // how far one step of each iterator moves through the flattened array
+    long stride = 1;
+    for (int i = indices.size(); i < dimensions.size(); i++) {
+        stride *= dimensions[i];
+    }
+    std::map<int, long> steps;
+    for (int i = indices.size() - 1; i >= 0; i--) {
+        for (std::pair<const int, long> &coefficient : indices[i].coefficients) {
+            steps[coefficient.first] += coefficient.second * stride;
+        }
+        stride *= dimensions[i];
+    }
+
+    long run = 1;
+    for (int loopID = access->loopID; loopID != -1; loopID = graphGenerator->loops[loopID].parent) {
+        if (steps[loopID] != run) {
+            break;
+        }
+        run *= std::max(1L, long(std::ceil(graphGenerator->loops[loopID].getTripcount())));
+    }
+    return run;
+}
+
+// elements of a run that come from memory together
+long BurstAnalysis::getWidenFactor(Node *array, long run) {
+    long factor = 1;
+    ExternalArrayNode *externalArray = dynamic_cast<ExternalArrayNode *>(array);
+    int bitwidth = Analysis::getBitwidth(array);
+    if (externalArray && externalArray->isAxi && bitwidth > 0) {
+        // ports are widened by powers of two
+        long elements = std::min(run, long(externalArray->axiInterface.maxWidenBitwidth / bitwidth));
+        while (factor * 2 <= elements) {
+            factor *= 2;
+        }
+        return factor;
+    }
+
+    // only reshaping the last dimension packs neighbouring elements together
+    std::vector<int> dimensions = Analysis::getArrayDimensions(array);
+    if (array->reshapeDim == dimensions.size()) {
+        if (array->reshapeType == "complete") {
+            factor = dimensions.back();
+        } else if (array->reshapeType == "cyclic") {
+            factor = array->reshapeFactor;
+        }
+    }
+    return std::max(1L, std::min(factor, run));
+}
+
+void BurstAnalysis::run() {
+    int sequentialAccesses = 0;
+    int widenedAccesses = 0;
+    int burstAccesses = 0;
+    double offChipBeats = 0;
+    double offChipTransactions = 0;
+    std::map<Node *, int> arrayBursts;
+
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        Node *access = node.get();
+        if (!memoryElements.count(access) || Analysis::isScalarElement(memoryElements[access])) {
+            continue;
+        }
+        Node *array = memoryElements[access];
+        DerefNode *address = Analysis::getAddress(predecessors, access);
+
+        long run = address ? getSequentialRun(access, address, array) : 1;
+        long widenFactor = getWidenFactor(array, run);
+        long words = long(std::ceil(double(run) / widenFactor));
+
+        bool isWrite = dynamic_cast<WriteNode *>(access);
+        ExternalArrayNode *externalArray = dynamic_cast<ExternalArrayNode *>(array);
+        long burstLength = 0;
+        if (externalArray && externalArray->isAxi && words > 1) {
+            AxiInterface &axiInterface = externalArray->axiInterface;
+            burstLength = std::min(words, long(isWrite ? axiInterface.maxWriteBurstLength
+                                                       : axiInterface.maxReadBurstLength));
+        }
+
+        access->sequentialRun = run;
+        access->widenFactor = widenFactor;
+        access->burstLength = burstLength;
+        if (address) {
+            address->sequentialRun = run;
+            address->widenFactor = widenFactor;
+            address->burstLength = burstLength;
+        }
+
+        sequentialAccesses += run > 1;
+        widenedAccesses += widenFactor > 1;
+        burstAccesses += burstLength > 1;
+        arrayBursts[array] = std::max(arrayBursts[array], int(burstLength));
+
+        // every copy of an off-chip access goes over the bus, a burst is one transaction
+        if (externalArray) {
+            double accesses = 1;
+            for (int loopID = access->loopID; loopID != -1; loopID = graphGenerator->loops[loopID].parent) {
+                accesses *= graphGenerator->loops[loopID].getTripcount();
+            }
+            double beats = std::ceil(accesses / widenFactor);
+            offChipBeats += beats;
+            offChipTransactions += burstLength > 1 ? std::ceil(beats / burstLength) : beats;
+        }
+
+        std::string index;
+        if (address) {
+            for (AffineIndex &dimension : address->indices) {
+                index += "[" + dimension.toString() + "]";
+            }
+        }
+        std::string kind = isWrite ? "write " : "read ";
+        graphGenerator->addReport(kind + Analysis::getArrayName(array) + (index.empty() ? "[?]" : index) +
+                                  ": runs of " + std::to_string(run) + ", " + std::to_string(widenFactor) +
+                                  " per access, bursts of " + std::to_string(burstLength));
+    }
+
+    for (std::pair<Node *const, int> &bursts : arrayBursts) {
+        graphGenerator->addStat("burstLength_" + Analysis::getArrayName(bursts.first), bursts.second, false);
+    }
+    graphGenerator->addStat("sequentialAccesses", sequentialAccesses, false);
+    graphGenerator->addStat("widenedAccesses", widenedAccesses, false);
+    graphGenerator->addStat("burstAccesses", burstAccesses, false);
+    graphGenerator->addStat("estOffChipBeats", offChipBeats, true);
+    graphGenerator->addStat("estOffChipTransactions", offChipTransactions, true);
+}
+
+} // namespace GNN
@@ -0,0 +1,39 @@
+#ifndef GNN_BURST_ANALYSIS_H
+#define GNN_BURST_ANALYSIS_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class DerefNode;
+
+// Finds the memory accesses that walk through an array in order, and how far.
+// The affine index of an access is flattened to one step per iterator, and the run grows out from
+// the innermost loop while each loop's step is the length of the run inside it.
+// A run is packed into words by a cyclic or complete ARRAY_RESHAPE of the last dimension,
+// or by the max_widen_bitwidth of an m_axi port, which then bursts up to its max burst length of words.
+// Only affine accesses are placed, the iterators are assumed to step by one.
+class BurstAnalysis {
+  public:
+    BurstAnalysis(GraphGenerator *graphGenerator);
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, std::vector<Node *>> predecessors;
+    std::map<Node *, Node *> memoryElements;
+
+    long getSequentialRun(Node *access, DerefNode *address, Node *array);
+    long getWidenFactor(Node *array, long run);
+};
+
+} // namespace GNN
+
+#endif
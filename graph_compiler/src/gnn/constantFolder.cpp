@@ -0,0 +1,269 @@
+#include "constantFolder.h"
+#include "nodeUtils.h"
+
+namespace {
+
+using GNN::DataType;
+using GNN::TypeStruct;
+
+// integers wrap around at their bitwidth like they do in hardware
+long long wrap(long long value, const TypeStruct &type) {
+    if (type.bitwidth <= 0 || type.bitwidth >= 64) {
+        return value;
+    }
+    unsigned long long mask = (1ULL << type.bitwidth) - 1;
+    unsigned long long bits = (unsigned long long)value & mask;
+    bool negative = (bits >> (type.bitwidth - 1)) & 1;
+    if (!type.isUnsigned && type.bitwidth > 1 && negative) {
+        return (long long)(bits | ~mask);
+    }
+    return bits;
+}
+
+std::string formatInteger(long long value, const TypeStruct &type) {
+    // matches how boolean literals are labelled
+    if (type.bitwidth == 1) {
+        return "Bool: " + std::to_string(value);
+    }
+    return std::to_string(value);
+}
+
+// boolean constants are labelled "Bool: 0" or "Bool: 1"
+long long getInteger(GNN::Node *node) {
+    std::string value = dynamic_cast<GNN::ConstantNode *>(node)->value;
+    if (value.rfind("Bool: ", 0) == 0) {
+        value = value.substr(6);
+    }
+    return std::stoll(value);
+}
+
+bool isPlainType(const TypeStruct &type) { return !type.isVoid && !type.stringOverride; }
+
+// integers narrower than int are computed as int
+TypeStruct promote(const TypeStruct &type) {
+    if (type.dataType == DataType::INTEGER && type.bitwidth < 32) {
+        return TypeStruct(DataType::INTEGER, 32);
+    }
+    return type;
+}
+
+// C's usual arithmetic conversions: after promotion the wider type wins,
+// and between integers of the same width unsigned wins
+TypeStruct getOperandType(VariantT variant, const TypeStruct &lhs, const TypeStruct &rhs) {
+    if (variant == V_SgLshiftOp || variant == V_SgRshiftOp) {
+        return promote(lhs);
+    }
+    if (lhs.dataType == DataType::FLOAT && rhs.dataType == DataType::FLOAT) {
+        return lhs.bitwidth >= rhs.bitwidth ? lhs : rhs;
+    } else if (lhs.dataType == DataType::FLOAT) {
+        return lhs;
+    } else if (rhs.dataType == DataType::FLOAT) {
+        return rhs;
+    }
+    TypeStruct promotedLhs = promote(lhs);
+    TypeStruct promotedRhs = promote(rhs);
+    if (promotedLhs.bitwidth != promotedRhs.bitwidth) {
+        return promotedLhs.bitwidth > promotedRhs.bitwidth ? promotedLhs : promotedRhs;
+    }
+    promotedLhs.isUnsigned = promotedLhs.isUnsigned || promotedRhs.isUnsigned;
+    return promotedLhs;
+}
+
+bool compare(VariantT variant, double a, double b) {
+    switch (variant) {
+    case V_SgLessThanOp:
+        return a < b;
+    case V_SgLessOrEqualOp:
+        return a <= b;
+    case V_SgEqualityOp:
+        return a == b;
+    case V_SgNotEqualOp:
+        return a != b;
+    case V_SgGreaterOrEqualOp:
+        return a >= b;
+    case V_SgGreaterThanOp:
+        return a > b;
+    }
+    return false;
+}
+
+} // namespace
+
+namespace GNN {
+
+bool ConstantFolder::getValue(Node *node, double &value) {
+    ConstantNode *constant = dynamic_cast<ConstantNode *>(node);
+    if (!constant || !constant->canGetValue() || !isPlainType(constant->getType())) {
+        return false;
+    }
+    value = constant->getValue();
+    return true;
+}
+
+// constants are only ever the source of an edge, or an input to an arithmetic unit or a cast
+bool ConstantFolder::isUsed(Node *node) {
+    return graphGenerator->variableMapper->nonReadVariables.count(node) || graphGenerator->edgeNodes.count(node);
+}
+
+void ConstantFolder::remove(Node *node) {
+    if (!isUsed(node)) {
+        graphGenerator->removeNode(node);
+        numRemoved++;
+    }
+}
+
+ConstantNode *ConstantFolder::makeConstant(double value, TypeStruct type) {
+    if (type.dataType == DataType::INTEGER) {
+        return new ConstantNode(formatInteger(wrap((long long)value, type), type), type);
+    }
+    return new ConstantNode(std::to_string(value), type);
+}
+
+Node *ConstantFolder::foldBinary(VariantT variant, Node *lhs, Node *rhs) {
+    double a, b;
+    if (!getValue(lhs, a) || !getValue(rhs, b)) {
+        return nullptr;
+    }
+    TypeStruct lhsType = lhs->getType();
+    TypeStruct rhsType = rhs->getType();
+    TypeStruct type = getOperandType(variant, lhsType, rhsType);
+    bool isFloat = lhsType.dataType == DataType::FLOAT || rhsType.dataType == DataType::FLOAT;
+
+    ConstantNode *result = nullptr;
+    if (Utils::isComparisonOp(variant)) {
+        // -1 < 0u is false, the -1 is converted to unsigned first
+        if (!isFloat) {
+            a = wrap(getInteger(lhs), type);
+            b = wrap(getInteger(rhs), type);
+        }
+        result = makeConstant(compare(variant, a, b), TypeStruct(DataType::INTEGER, 1));
+    } else if (isFloat) {
+        switch (variant) {
+        case V_SgAddOp:
+            result = makeConstant(a + b, type);
+            break;
+        case V_SgSubtractOp:
+            result = makeConstant(a - b, type);
+            break;
+        case V_SgMultiplyOp:
+            result = makeConstant(a * b, type);
+            break;
+        case V_SgDivideOp:
+            if (b != 0) {
+                result = makeConstant(a / b, type);
+            }
+            break;
+        }
+    } else {
+        // integer constants go through long long so large values and division stay exact
+        // the shift amount isn't converted, it doesn't change the type of the result
+        long long x = wrap(getInteger(lhs), type);
+        bool isShift = variant == V_SgLshiftOp || variant == V_SgRshiftOp;
+        long long y = isShift ? getInteger(rhs) : wrap(getInteger(rhs), type);
+        long long value;
+        bool valid = true;
+        switch (variant) {
+        case V_SgAddOp:
+            value = x + y;
+            break;
+        case V_SgSubtractOp:
+            value = x - y;
+            break;
+        case V_SgMultiplyOp:
+            value = x * y;
+            break;
+        case V_SgDivideOp:
+            valid = y != 0;
+            value = valid ? x / y : 0;
+            break;
+        case V_SgLshiftOp:
+            valid = y >= 0 && y < 64;
+            value = valid ? (long long)((unsigned long long)x << y) : 0;
+            break;
+        case V_SgRshiftOp:
+            valid = y >= 0 && y < 64;
+            value = valid ? x >> y : 0;
+            break;
+        case V_SgBitAndOp:
+            value = x & y;
+            break;
+        case V_SgBitXorOp:
+            value = x ^ y;
+            break;
+        default:
+            valid = false;
+        }
+        if (valid) {
+            result = new ConstantNode(formatInteger(wrap(value, type), type), type);
+        }
+    }
+
+    if (!result) {
+        return nullptr;
+    }
+    numFolded++;
+    remove(lhs);
+    if (rhs != lhs) {
+        remove(rhs);
+    }
+    return result;
+}
+
+Node *ConstantFolder::foldUnary(VariantT variant, Node *input) {
+    double a;
+    if (!getValue(input, a)) {
+        return nullptr;
+    }
+    TypeStruct type = promote(input->getType());
+
+    ConstantNode *result = nullptr;
+    switch (variant) {
+    case V_SgMinusOp:
+        if (type.dataType == DataType::FLOAT) {
+            result = makeConstant(-a, type);
+        } else {
+            result = new ConstantNode(formatInteger(wrap(-getInteger(input), type), type), type);
+        }
+        break;
+    case V_SgNotOp:
+        result = makeConstant(a == 0, TypeStruct(DataType::INTEGER, 1));
+        break;
+    case V_SgBitComplementOp:
+        if (type.dataType == DataType::INTEGER) {
+            result = new ConstantNode(formatInteger(wrap(~getInteger(input), type), type), type);
+        }
+        break;
+    }
+
+    if (!result) {
+        return nullptr;
+    }
+    numFolded++;
+    remove(input);
+    return result;
+}
+
+Node *ConstantFolder::foldCast(Node *input, const std::string &type) {
+    double a;
+    if (!getValue(input, a)) {
+        return nullptr;
+    }
+    TypeStruct castType = TypeStruct(type);
+    if (!isPlainType(castType)) {
+        return nullptr;
+    }
+
+    ConstantNode *result;
+    if (castType.dataType == DataType::INTEGER && input->getType().dataType == DataType::INTEGER) {
+        result = new ConstantNode(formatInteger(wrap(getInteger(input), castType), castType), castType);
+    } else {
+        // float to int truncates towards zero, which the conversion to long long does
+        result = makeConstant(a, castType);
+    }
+
+    numFolded++;
+    remove(input);
+    return result;
+}
+
+} // namespace GNN
@@ -0,0 +1,47 @@
+#ifndef GNN_CONSTANT_FOLDER_H
+#define GNN_CONSTANT_FOLDER_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include "rose.h"
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class ConstantNode;
+
+// Folds operations on constants while the graph is built, so they never become nodes.
+// Folding as nodes are made means a folded operation never gets edges, which a pass over the finished graph
+// would have to rewire.
+//
+// The fold functions return nullptr when the operation can't be folded,
+// the operands are left alone then. When it can, the operands are taken out of the graph
+// unless something else is already using them.
+class ConstantFolder {
+  public:
+    ConstantFolder(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {}
+
+    Node *foldBinary(VariantT variant, Node *lhs, Node *rhs);
+    Node *foldUnary(VariantT variant, Node *input);
+    Node *foldCast(Node *input, const std::string &type);
+
+    // the numerical value of a node, if it's a constant that has one
+    bool getValue(Node *node, double &value);
+
+    // takes a constant out of the graph if no edge uses it
+    void remove(Node *node);
+
+    int numFolded = 0;
+    int numRemoved = 0;
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    bool isUsed(Node *node);
+    ConstantNode *makeConstant(double value, TypeStruct type);
+};
+
+} // namespace GNN
+
+#endif
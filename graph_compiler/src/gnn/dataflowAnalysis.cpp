@@ -0,0 +1,145 @@
+#include "dataflowAnalysis.h"
+#include "analysisUtils.h"
+#include "args.h"
+
+namespace GNN {
+
+DataflowAnalysis::DataflowAnalysis(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+}
+
+// an access counts for the stage it's in, and every stage that stage is nested in
+void DataflowAnalysis::addAccess(Node *node, Node *element, bool read, bool written) {
+    int stage = node->dataflowStage;
+    while (stage != -1) {
+        Access &access = stageAccesses[stage][element];
+        if (read) {
+            access.read = true;
+            if (!access.firstRead) {
+                access.firstRead = node;
+            }
+        }
+        if (written) {
+            access.written = true;
+            access.lastWrite = node;
+        }
+        stage = graphGenerator->dataflowRegions[graphGenerator->dataflowStages[stage].region].parentStage;
+    }
+}
+
+// a function reads or writes the arrays it's passed the same way it uses its parameters
+void DataflowAnalysis::addCallAccesses(FunctionCallEdge *callEdge) {
+    VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+    SgInitializedNamePtrList &args = callEdge->funcDec->get_parameterList()->get_args();
+
+    for (int i = 0; i < callEdge->parameters.size(); i++) {
+        SgExpression *parameter = callEdge->parameters[i];
+        for (SgNode *node : NodeQuery::querySubTree(parameter, V_SgVarRefExp)) {
+            SgVarRefExp *varRef = isSgVarRefExp(node);
+            SgInitializedName *varDec = varRef->get_symbol()->get_declaration();
+            SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+            if (!variableMapper->variableToReadNode.count(underlyingVariable)) {
+                continue;
+            }
+            Node *element = variableMapper->variableToReadNode[underlyingVariable];
+
+            // only arrays and pointers passed on their own can be written,
+            // anything else is a value read before the call
+            bool read = true;
+            bool written = false;
+            if (varRef == parameter && i < args.size()) {
+                SgType *type = args[i]->get_type();
+                written = isSgArrayType(type) || isSgPointerType(type) || isSgReferenceType(type);
+                if (written && callEdge->funcDec->get_definition() && variableMapper->variableToReadNode.count(args[i])) {
+                    Access &access = elementAccesses[variableMapper->variableToReadNode[args[i]]];
+                    read = access.read;
+                    written = access.written;
+                }
+            }
+            addAccess(callEdge->funcCallNode, element, read, written);
+        }
+    }
+}
+
+void DataflowAnalysis::run() {
+    graphGenerator->dataflowChannels.clear();
+    if (graphGenerator->dataflowRegions.empty()) {
+        return;
+    }
+
+    for (Node *node : graphGenerator->nodes) {
+        if (memoryElements.count(node)) {
+            Access &access = elementAccesses[memoryElements[node]];
+            if (dynamic_cast<WriteNode *>(node)) {
+                access.written = true;
+            } else {
+                access.read = true;
+            }
+        }
+    }
+    // parameters passed on to another call could be used any way
+    for (Edge *edge : graphGenerator->edges) {
+        if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+            for (SgExpression *parameter : callEdge->parameters) {
+                if (SgVarRefExp *varRef = isSgVarRefExp(parameter)) {
+                    SgInitializedName *varDec = varRef->get_symbol()->get_declaration();
+                    SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+                    if (variableMapper->variableToReadNode.count(underlyingVariable)) {
+                        Access &access = elementAccesses[variableMapper->variableToReadNode[underlyingVariable]];
+                        access.read = true;
+                        access.written = true;
+                    }
+                }
+            }
+        }
+    }
+
+    for (Node *node : graphGenerator->nodes) {
+        if (node->dataflowStage != -1 && memoryElements.count(node)) {
+            bool written = dynamic_cast<WriteNode *>(node);
+            addAccess(node, memoryElements[node], !written, written);
+        }
+    }
+    for (Edge *edge : graphGenerator->edges) {
+        if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            if (callEdge->funcCallNode->dataflowStage != -1) {
+                addCallAccesses(callEdge);
+            }
+        }
+    }
+
+    // each element a stage reads comes from the last stage before it that wrote it
+    for (DataflowRegion &region : graphGenerator->dataflowRegions) {
+        for (int j = 0; j < region.stages.size(); j++) {
+            int consumer = region.stages[j];
+            for (std::pair<Node *const, Access> &access : stageAccesses[consumer]) {
+                if (!access.second.read) {
+                    continue;
+                }
+                for (int i = j - 1; i >= 0; i--) {
+                    int producer = region.stages[i];
+                    std::map<Node *, Access>::iterator write = stageAccesses[producer].find(access.first);
+                    if (write == stageAccesses[producer].end() || !write->second.written) {
+                        continue;
+                    }
+
+                    graphGenerator->dataflowChannels.push_back({producer, consumer, access.first});
+                    graphGenerator->addReport("channel: " + graphGenerator->dataflowStages[producer].label + " -> " +
+                                              graphGenerator->dataflowStages[consumer].label + " through " +
+                                              Analysis::getElementName(access.first));
+                    if (graphGenerator->checkArg(ADD_DATAFLOW)) {
+                        new DataflowChannelEdge(write->second.lastWrite, access.second.firstRead);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    graphGenerator->addStat("dataflowRegions", graphGenerator->dataflowRegions.size(), false);
+    graphGenerator->addStat("dataflowStages", graphGenerator->dataflowStages.size(), false);
+    graphGenerator->addStat("dataflowChannels", graphGenerator->dataflowChannels.size(), false);
+}
+
+} // namespace GNN
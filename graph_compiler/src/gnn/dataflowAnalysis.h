@@ -0,0 +1,47 @@
+#ifndef GNN_DATAFLOW_ANALYSIS_H
+#define GNN_DATAFLOW_ANALYSIS_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class FunctionCallEdge;
+
+// Finds the channels between the stages of each DATAFLOW region.
+// A stage accesses an element if one of its nodes does, or if it passes the element to a function that accesses
+// that parameter. An element one stage writes and a later stage reads is a channel from the first to the second.
+// With --add_dataflow, each channel becomes an edge from the producer's last write to the consumer's first read.
+class DataflowAnalysis {
+  public:
+    DataflowAnalysis(GraphGenerator *graphGenerator);
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, Node *> memoryElements;
+
+    struct Access {
+        bool read = false;
+        bool written = false;
+        Node *firstRead = nullptr;
+        Node *lastWrite = nullptr;
+    };
+    // the elements each stage accesses, and how
+    std::map<int, std::map<Node *, Access>> stageAccesses;
+    // how each function accesses each of its own elements
+    std::map<Node *, Access> elementAccesses;
+
+    void addAccess(Node *node, Node *element, bool read, bool written);
+    void addCallAccesses(FunctionCallEdge *callEdge);
+};
+
+} // namespace GNN
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef GNN_DATAFLOW_INFO_H
+#define GNN_DATAFLOW_INFO_H
+
+#include "rose.h"
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+class Node;
+
+// A function or loop body with a DATAFLOW pragma
+// its top level statements are stages, which run at the same time
+struct DataflowRegion {
+    int id;
+    // the loop the region is the body of, -1 for a function body
+    int loopID = -1;
+    SgFunctionDeclaration *funcDec = nullptr;
+    // the stage the region is inside of, -1 if it isn't nested in another region
+    int parentStage = -1;
+
+    std::vector<int> stages;
+
+    // filled in by the analysis passes
+    double latency = 0;
+};
+
+// A statement in a dataflow region, nodes made while parsing it have its id as their dataflowStage
+struct DataflowStage {
+    int id;
+    int region;
+    std::string label;
+    // the function the stage calls, if it's a call statement
+    SgFunctionDeclaration *callee = nullptr;
+
+    // filled in by the analysis passes
+    double latency = 0;
+};
+
+// A variable or array one stage writes and a later stage of the same region reads
+struct DataflowChannel {
+    int producer;
+    int consumer;
+    Node *element;
+};
+
+} // namespace GNN
+
+#endif
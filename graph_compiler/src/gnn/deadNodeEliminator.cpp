@@ -0,0 +1,258 @@
+#include "deadNodeEliminator.h"
+
+namespace GNN {
+
+// every node an edge refers to, the edge can't be printed without all of them
+std::vector<Node *> DeadNodeEliminator::getEdgeNodes(Edge *edge) {
+    std::vector<Node *> edgeNodes = {edge->source, edge->destination};
+
+    if (ArithmeticUnitEdge *arithmeticEdge = dynamic_cast<ArithmeticUnitEdge *>(edge)) {
+        edgeNodes.insert(edgeNodes.end(), {arithmeticEdge->lhs, arithmeticEdge->rhs, arithmeticEdge->unit});
+    } else if (ImplicitCastDataFlowEdge *castEdge = dynamic_cast<ImplicitCastDataFlowEdge *>(edge)) {
+        edgeNodes.push_back(castEdge->typeDependency);
+    } else if (MemoryAddressEdge *addressEdge = dynamic_cast<MemoryAddressEdge *>(edge)) {
+        edgeNodes.push_back(addressEdge->typeDependency);
+    } else if (ResolvedMemoryAddressEdge *resolvedEdge = dynamic_cast<ResolvedMemoryAddressEdge *>(edge)) {
+        edgeNodes.push_back(resolvedEdge->memoryElement);
+    } else if (StructAccessEdge *structEdge = dynamic_cast<StructAccessEdge *>(edge)) {
+        edgeNodes.push_back(structEdge->accessNode);
+    } else if (ReturnEdge *returnEdge = dynamic_cast<ReturnEdge *>(edge)) {
+        edgeNodes.push_back(returnEdge->functionReturn);
+    } else if (LoopBackEdge *loopBackEdge = dynamic_cast<LoopBackEdge *>(edge)) {
+        edgeNodes.push_back(loopBackEdge->branch);
+    } else if (RevertControlFlowEdge *revertEdge = dynamic_cast<RevertControlFlowEdge *>(edge)) {
+        edgeNodes.push_back(revertEdge->nodeToRevertTo);
+    } else if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+        edgeNodes.push_back(callEdge->funcCallNode);
+    }
+
+    std::vector<Node *> nonNull;
+    for (Node *node : edgeNodes) {
+        if (node) {
+            nonNull.push_back(node);
+        }
+    }
+    return nonNull;
+}
+
+// a node being live makes its inputs live
+void DeadNodeEliminator::addInputs() {
+    for (Edge *edge : graphGenerator->edges) {
+        if (edge->source && edge->destination) {
+            inputs[edge->destination].push_back(edge->source);
+        }
+
+        if (ArithmeticUnitEdge *arithmeticEdge = dynamic_cast<ArithmeticUnitEdge *>(edge)) {
+            inputs[arithmeticEdge->unit].push_back(arithmeticEdge->lhs);
+            if (arithmeticEdge->rhs) {
+                inputs[arithmeticEdge->unit].push_back(arithmeticEdge->rhs);
+            }
+        } else if (ImplicitCastDataFlowEdge *castEdge = dynamic_cast<ImplicitCastDataFlowEdge *>(edge)) {
+            if (castEdge->typeDependency && castEdge->destination) {
+                inputs[castEdge->destination].push_back(castEdge->typeDependency);
+            }
+        } else if (MemoryAddressEdge *addressEdge = dynamic_cast<MemoryAddressEdge *>(edge)) {
+            if (addressEdge->typeDependency && addressEdge->destination) {
+                inputs[addressEdge->destination].push_back(addressEdge->typeDependency);
+            }
+        } else if (ResolvedMemoryAddressEdge *resolvedEdge = dynamic_cast<ResolvedMemoryAddressEdge *>(edge)) {
+            if (resolvedEdge->memoryElement && resolvedEdge->destination) {
+                inputs[resolvedEdge->destination].push_back(resolvedEdge->memoryElement);
+            }
+        } else if (dynamic_cast<MemoryBankEdge *>(edge)) {
+            // accesses are only connected to the banks when they're printed, so the array keeps all of them
+            inputs[edge->source].push_back(edge->destination);
+        } else if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            // parameters are only read when the call is printed, so the variables they use have no edges yet
+            VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+            for (SgExpression *parameter : callEdge->parameters) {
+                for (SgNode *node : NodeQuery::querySubTree(parameter, V_SgVarRefExp)) {
+                    SgInitializedName *varDec = isSgVarRefExp(node)->get_symbol()->get_declaration();
+                    SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+                    if (variableMapper->variableToReadNode.count(underlyingVariable)) {
+                        inputs[callEdge->funcCallNode].push_back(variableMapper->variableToReadNode[underlyingVariable]);
+                    }
+                }
+            }
+        }
+    }
+
+    // types are taken from other nodes when printing
+    for (Node *node : graphGenerator->nodes) {
+        std::vector<Node *> nodeInputs;
+        if (ReadNode *read = dynamic_cast<ReadNode *>(node)) {
+            nodeInputs = {read->typeDependency};
+        } else if (WriteNode *write = dynamic_cast<WriteNode *>(node)) {
+            nodeInputs = {write->typeDependency, write->immediateInput};
+        } else if (DerefNode *deref = dynamic_cast<DerefNode *>(node)) {
+            nodeInputs = {deref->memoryElement, deref->typeDependency, deref->baseTypeDependency};
+        } else if (ComparisonNode *comparison = dynamic_cast<ComparisonNode *>(node)) {
+            nodeInputs = {comparison->lhs, comparison->rhs};
+        }
+        for (Node *input : nodeInputs) {
+            if (input) {
+                inputs[node].push_back(input);
+            }
+        }
+    }
+}
+
+std::vector<Node *> DeadNodeEliminator::getRoots() {
+    std::vector<Node *> roots;
+    for (Node *node : graphGenerator->nodes) {
+        switch (node->getVariant()) {
+        case NodeVariant::EXTERNAL:
+        case NodeVariant::BRANCH:
+        case NodeVariant::RETURN:
+        case NodeVariant::EXTERNAL_ARRAY:
+        case NodeVariant::PARAMETER_ARRAY:
+        case NodeVariant::PARAMETER_SCALAR:
+        case NodeVariant::STRUCT:
+            roots.push_back(node);
+            break;
+        }
+    }
+
+    for (Edge *edge : graphGenerator->edges) {
+        if (WriteMemoryElementEdge *writeEdge = dynamic_cast<WriteMemoryElementEdge *>(edge)) {
+            // writes to local variables only matter if something reads them
+            NodeVariant variant = writeEdge->destination->getVariant();
+            if (variant != NodeVariant::LOCAL_SCALAR && variant != NodeVariant::LOCAL_ARRAY) {
+                roots.push_back(writeEdge->source);
+            }
+        } else if (ReturnEdge *returnEdge = dynamic_cast<ReturnEdge *>(edge)) {
+            if (returnEdge->functionReturn) {
+                roots.push_back(returnEdge->functionReturn);
+            }
+        } else if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            // a defined function can write to its parameters, an undefined one is only kept if its result is used
+            if (callEdge->funcDec->get_definition()) {
+                roots.push_back(callEdge->funcCallNode);
+            }
+        }
+    }
+    return roots;
+}
+
+void DeadNodeEliminator::markLive(std::vector<Node *> roots) {
+    std::vector<Node *> stack = roots;
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+        if (live.count(node)) {
+            continue;
+        }
+        live.insert(node);
+
+        if (inputs.count(node)) {
+            for (Node *input : inputs[node]) {
+                if (!live.count(input)) {
+                    stack.push_back(input);
+                }
+            }
+        }
+    }
+}
+
+// undefined functions whose calls were all removed
+std::set<SgFunctionDeclaration *> DeadNodeEliminator::getUncalledFunctions() {
+    std::set<SgFunctionDeclaration *> called;
+    std::set<SgFunctionDeclaration *> undefined;
+    for (Edge *edge : graphGenerator->edges) {
+        if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            if (!callEdge->funcDec->get_definition()) {
+                undefined.insert(callEdge->funcDec);
+            }
+            if (live.count(callEdge->funcCallNode)) {
+                called.insert(callEdge->funcDec);
+            }
+        }
+    }
+
+    std::set<SgFunctionDeclaration *> uncalled;
+    for (SgFunctionDeclaration *funcDec : undefined) {
+        if (!called.count(funcDec)) {
+            uncalled.insert(funcDec);
+        }
+    }
+    return uncalled;
+}
+
+void DeadNodeEliminator::run() {
+    addInputs();
+    markLive(getRoots());
+
+    // an uncalled undefined function is only its start, its return and the control flow back to external
+    std::set<Edge *> deadEdges;
+    AstParser *astParser = graphGenerator->astParser.get();
+    for (SgFunctionDeclaration *funcDec : getUncalledFunctions()) {
+        if (astParser->functionStartEdgeMap.count(funcDec)) {
+            deadEdges.insert(astParser->functionStartEdgeMap[funcDec]);
+        }
+        if (astParser->functionReturnEdgeMap.count(funcDec)) {
+            deadEdges.insert(astParser->functionReturnEdgeMap[funcDec]);
+        }
+    }
+
+    std::vector<Edge *> liveEdges;
+    bool afterDeadReturn = false;
+    for (Edge *edge : graphGenerator->edges) {
+        bool dead = deadEdges.count(edge);
+        for (Node *node : getEdgeNodes(edge)) {
+            if (!live.count(node)) {
+                dead = true;
+            }
+        }
+        // handleFuncDec adds the control flow back to external straight after the return
+        if (afterDeadReturn && edge->getVariant() == EdgeVariant::CONTROL_FLOW) {
+            dead = true;
+        }
+        afterDeadReturn = deadEdges.count(edge) && dynamic_cast<ReturnEdge *>(edge);
+
+        if (dead) {
+            deadEdges.insert(edge);
+        } else {
+            liveEdges.push_back(edge);
+        }
+    }
+
+    std::vector<Node *> liveNodes;
+    int numDeadNodes = 0;
+    for (Node *node : graphGenerator->nodes) {
+        if (live.count(node)) {
+            liveNodes.push_back(node);
+        } else {
+            numDeadNodes++;
+        }
+    }
+
+    int numDeadEdges = graphGenerator->edges.size() - liveEdges.size();
+    graphGenerator->nodes = liveNodes;
+    graphGenerator->edges = liveEdges;
+
+    // live nodes can still take their type from a dead one, so they're moved rather than freed
+    std::vector<std::unique_ptr<Node>> liveNodes_unq;
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (live.count(node.get())) {
+            liveNodes_unq.push_back(std::move(node));
+        } else {
+            graphGenerator->removedNodes.push_back(std::move(node));
+        }
+    }
+    graphGenerator->nodes_unq = std::move(liveNodes_unq);
+
+    std::vector<std::unique_ptr<Edge>> liveEdges_unq;
+    for (std::unique_ptr<Edge> &edge : graphGenerator->edges_unq) {
+        if (deadEdges.count(edge.get())) {
+            graphGenerator->removedEdges.push_back(std::move(edge));
+        } else {
+            liveEdges_unq.push_back(std::move(edge));
+        }
+    }
+    graphGenerator->edges_unq = std::move(liveEdges_unq);
+
+    graphGenerator->addStat("deadNodes", numDeadNodes, false);
+    graphGenerator->addStat("deadEdges", numDeadEdges, false);
+}
+
+} // namespace GNN
@@ -0,0 +1,44 @@
+#ifndef GNN_DEAD_NODE_ELIMINATOR_H
+#define GNN_DEAD_NODE_ELIMINATOR_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <set>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class Edge;
+
+// Removes nodes whose values never reach a side effect, and the edges that touch them.
+// Side effects are writes to anything that isn't a local variable, return values, calls to defined functions,
+// and branches. A local variable is live if a live node reads it, and then every write to it is live too.
+//
+// Runs on the graph from parsing, before the analyses and printing.
+// Dead nodes are kept allocated, as live nodes can still take their types from them.
+class DeadNodeEliminator {
+  public:
+    DeadNodeEliminator(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {}
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    // the nodes each node takes values, addresses or types from
+    std::map<Node *, std::vector<Node *>> inputs;
+    std::set<Node *> live;
+
+    std::vector<Node *> getEdgeNodes(Edge *edge);
+    void addInputs();
+    std::vector<Node *> getRoots();
+    void markLive(std::vector<Node *> roots);
+    std::set<SgFunctionDeclaration *> getUncalledFunctions();
+};
+
+} // namespace GNN
+
+#endif
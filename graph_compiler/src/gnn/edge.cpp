@@ -1,5 +1,6 @@
 #include "edge.h"
 #include "args.h"
+#include <algorithm>
 
 namespace GNN {
 
@@ -20,8 +21,14 @@ void Edges::updatePreviousControlFlowNode(Node *node) {
 
 void Edges::addPreviousControlFlowNodeChangeListener(Edge *edge) { previousControlFlowNodeChangeListeners.push(edge); }
 
+void Edges::resetPreviousControlFlowNode() {
+    previousControlFlowNode = nullptr;
+    previousControlFlowNodeChangeListeners = std::queue<Edge *>();
+}
+
 Edge::Edge(Node *source, Node *destination) : source(source), destination(destination) {
     Edges::graphGenerator->edges.push_back(this);
+    Edges::graphGenerator->edgeNodes.insert({source, destination});
 
     // give to unique pointer to manage memory automatically
     std::unique_ptr<Edge> edge_unique = std::unique_ptr<Edge>(this);
@@ -81,6 +88,16 @@ void InlineFunctionPragmaEdge::run() {
     }
 }
 
+void ArrayReshapePragmaEdge::run() {
+    if (!Edges::graphGenerator->checkArg(ABSORB_PRAGMAS)) {
+        Edges::printPragmaEdge(source, destination, 4);
+    }
+}
+
+void DataflowChannelEdge::run() { Edges::printChannelEdge(source, destination); }
+
+void MemoryBankEdge::run() { Edges::printBankEdge(source, destination); }
+
 void DataFlowEdge::run() {
     Edges::graphGenerator->stateNode = destination;
     bool sourceIsConstant = source->getVariant() == NodeVariant::CONSTANT;
@@ -132,6 +149,13 @@ void ReadMemoryElementEdge::run() {
         if (elementIsScalar) {
             (new MemoryAddressEdge(source, destination))->run();
         }
+    } else if (!destination->memoryBanks.empty()) {
+        // the banks the read can reach stand in for the array
+        for (Node *bank : destination->memoryBanks) {
+            MemoryAddressEdge *edge = new MemoryAddressEdge(bank, destination);
+            edge->typeDependency = source;
+            edge->run();
+        }
     } else {
         MemoryAddressEdge *edge = new MemoryAddressEdge(source, destination);
         edge->typeDependency = source;
@@ -155,6 +179,12 @@ void WriteMemoryElementEdge::run() {
         if (elementIsScalar) {
             (new MemoryAddressEdge(destination, source))->run();
         }
+    } else if (!source->memoryBanks.empty()) {
+        for (Node *bank : source->memoryBanks) {
+            MemoryAddressEdge *edge = new MemoryAddressEdge(source, bank);
+            edge->typeDependency = destination;
+            edge->run();
+        }
     } else {
         MemoryAddressEdge *edge = new MemoryAddressEdge(source, destination);
         edge->typeDependency = destination;
@@ -189,6 +219,7 @@ void MemoryAddressEdge::run() {
             typeNode = new TypeNode(getElemType(), sourceIsConstant);
             typeNode->print();
         }
+        typeNode->bankConflicts = std::max(source->bankConflicts, destination->bankConflicts);
 
         Edges::printSubMemoryAddressEdge(typeNode, destination);
         if (sourceToType) {
@@ -233,7 +264,13 @@ void ResolvedMemoryAddressEdge::run() {
             (new ControlFlowEdge(writeNode))->run();
             (new DataFlowEdge(source, writeNode))->run();
 
-            (new SpecifyAddressEdge(writeNode, memoryElement))->run();
+            if (source->memoryBanks.empty()) {
+                (new SpecifyAddressEdge(writeNode, memoryElement))->run();
+            } else {
+                for (Node *bank : source->memoryBanks) {
+                    (new SpecifyAddressEdge(writeNode, bank))->run();
+                }
+            }
         } else {
             throw std::runtime_error("Resolved memory address edge didn't come from a dereference node");
         }
@@ -270,7 +307,7 @@ void SextDataFlowEdge::run() {
             source->setType(TypeStruct(source->getSextType().dataType, bitLimit));
             addSexts = false;
         } else {
-            TypeStruct type = source->getSextType();
+            TypeStruct type = source->getRangeSextType();
             if (type.bitwidth >= bitLimit) {
                 addSexts = false;
             }
@@ -279,7 +316,7 @@ void SextDataFlowEdge::run() {
 
     if (addSexts) {
         Edges::graphGenerator->stateNode = destination;
-        Node *sext = new SextNode(bitLimit, source->getSextType().isUnsigned);
+        Node *sext = new SextNode(bitLimit, source->getRangeSextType().isUnsigned);
         sext->print();
 
         (new DataFlowEdge(source, sext))->run();
@@ -584,10 +621,19 @@ void BackControlFlowEdge::run() {
     Edges::updatePreviousControlFlowNode(destination);
 }
 
+// operands are only narrowed to their ranges when the unit's range is known too,
+// otherwise the unit could overflow at the narrower width
+TypeStruct getOperandType(Node *operand, Node *unit) {
+    if (unit->rangeBitwidth > 0) {
+        return operand->getRangeSextType();
+    }
+    return operand->getSextType();
+}
+
 void ArithmeticUnitEdge::run() {
-    TypeStruct lhsType = lhs->getSextType();
-    TypeStruct rhsType = rhs->getSextType();
-    int unitMinBitwidth = unit->minBitwidth();
+    TypeStruct lhsType = getOperandType(lhs, unit);
+    TypeStruct rhsType = getOperandType(rhs, unit);
+    int unitMinBitwidth = std::max(unit->minBitwidth(), unit->rangeBitwidth);
 
     if (lhsType.stringOverride || rhsType.stringOverride) {
         throw std::runtime_error("Overridden types cannot be used in an arithmetic unit: " + lhsType.overriddenString +
@@ -656,9 +702,9 @@ void ArithmeticUnitEdge::run() {
 
 TypeStruct ArithmeticUnitEdge::getType() {
     DataType outputType;
-    TypeStruct lhsType = lhs->getSextType();
-    TypeStruct rhsType = rhs->getSextType();
-    int unitMinBitwidth = unit->minBitwidth();
+    TypeStruct lhsType = getOperandType(lhs, unit);
+    TypeStruct rhsType = getOperandType(rhs, unit);
+    int unitMinBitwidth = std::max(unit->minBitwidth(), unit->rangeBitwidth);
     if (lhsType.dataType == DataType::FLOAT || rhsType.dataType == DataType::FLOAT) {
         outputType = DataType::FLOAT;
     } else {
@@ -674,7 +720,14 @@ TypeStruct ArithmeticUnitEdge::getType() {
 ImplicitCastDataFlowEdge::ImplicitCastDataFlowEdge(Node *lhs, Node *rhs) : Edge(lhs, rhs), typeDependency(rhs) {}
 
 ImplicitCastDataFlowEdge::ImplicitCastDataFlowEdge(Node *lhs, Node *rhs, Node *typeDependency)
-    : Edge(lhs, rhs), typeDependency(typeDependency) {}
+    : Edge(lhs, rhs), typeDependency(typeDependency) {
+    Edges::graphGenerator->edgeNodes.insert(typeDependency);
+}
+
+ArithmeticUnitEdge::ArithmeticUnitEdge(Node *lhs, Node *rhs, Node *unit)
+    : Edge(nullptr, nullptr), lhs(lhs), rhs(rhs), unit(unit) {
+    Edges::graphGenerator->edgeNodes.insert({lhs, rhs, unit});
+}
 
 void ImplicitCastDataFlowEdge::run() {
     TypeStruct type = typeDependency->getType();
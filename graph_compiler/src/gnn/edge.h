@@ -21,6 +21,7 @@ class Edges {
     static Node *getPreviousControlFlowNode();
     static void updatePreviousControlFlowNode(Node *node);
     static void addPreviousControlFlowNodeChangeListener(Edge *edge);
+    static void resetPreviousControlFlowNode();
 
     static void printSubControlFlowEdge(Node *source, Node *destination);
     static void printSubControlFlowEdge(Node *source, Node *destination, bool backEdge);
@@ -30,6 +31,8 @@ class Edges {
     static void printSubDataFlowEdge(Node *source, Node *destination);
     static void printSubDataFlowEdge(Node *source, Node *destination, int order);
     static void printPragmaEdge(Node *source, Node *destination, int order);
+    static void printChannelEdge(Node *source, Node *destination);
+    static void printBankEdge(Node *source, Node *destination);
 
   private:
     static Node *previousControlFlowNode;
@@ -80,6 +83,23 @@ class ArrayPartitionPragmaEdge : public Edge {
     std::string toString() override { return "Array Partition Edge"; }
 };
 
+class ArrayReshapePragmaEdge : public Edge {
+  public:
+    ArrayReshapePragmaEdge(Node *source, Node *destination) : Edge(source, destination) {}
+
+    void run() override;
+    std::string toString() override { return "Array Reshape Edge"; }
+};
+
+// from a partitioned array to each of its banks, with --bank_nodes
+class MemoryBankEdge : public Edge {
+  public:
+    MemoryBankEdge(Node *source, Node *destination) : Edge(source, destination) {}
+
+    void run() override;
+    std::string toString() override { return "Memory Bank Edge"; }
+};
+
 class ResourceAllocationPragmaEdge : public Edge {
   public:
     ResourceAllocationPragmaEdge(Node *source, Node *destination) : Edge(source, destination) {}
@@ -347,7 +367,7 @@ class BackControlFlowEdge : public Edge {
 
 class ArithmeticUnitEdge : public Edge {
   public:
-    ArithmeticUnitEdge(Node *lhs, Node *rhs, Node *unit) : lhs(lhs), rhs(rhs), unit(unit), Edge(nullptr, nullptr) {}
+    ArithmeticUnitEdge(Node *lhs, Node *rhs, Node *unit);
 
     Node *lhs, *rhs, *unit;
 
@@ -369,6 +389,15 @@ class ImplicitCastDataFlowEdge : public Edge {
     void run() override;
 };
 
+// data passed from one stage of a DATAFLOW region to a later one, through a variable or array
+class DataflowChannelEdge : public Edge {
+  public:
+    DataflowChannelEdge(Node *source, Node *destination) : Edge(source, destination) {}
+
+    void run() override;
+    std::string toString() override { return "Dataflow Channel"; }
+};
+
 class StructAccessEdge : public Edge {
   public:
     StructAccessEdge(Node *accessNode) : accessNode(accessNode), Edge(nullptr, nullptr) {}
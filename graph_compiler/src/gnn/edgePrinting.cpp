@@ -1,6 +1,7 @@
 #include "args.h"
 #include "edge.h"
 #include "edgePrinter.h"
+#include <algorithm>
 
 namespace {
 
@@ -47,6 +48,10 @@ void EdgePrinter::print() {
         attributes["xlabel"] = attributes["edgeOrder"];
     }
 
+    if (GraphRecorder *recorder = Edges::graphGenerator->recorder) {
+        recorder->addEdge(id1, id2, attributes);
+    }
+
     for (std::pair<std::string, std::string> attribute : attributes) {
         out += attribute.first;
         out += "=\"";
@@ -64,7 +69,15 @@ void Edges::printSubControlFlowEdge(Node *source, Node *destination) {
 void Edges::printSubControlFlowEdge(Node *source, Node *destination, bool backEdge) {
     if (source->getVariant() == NodeVariant::EXTERNAL || destination->getVariant() == NodeVariant::EXTERNAL) {
         printSubFunctionCallEdge(source, destination, source->functionID);
-    } else if (!graphGenerator->checkArg(IGNORE_CONTROL_FLOW)) {
+        return;
+    }
+    // back edges are drawn from the loop start to the end
+    if (backEdge) {
+        graphGenerator->addBBEdge(destination, source);
+    } else {
+        graphGenerator->addBBEdge(source, destination);
+    }
+    if (!graphGenerator->checkArg(IGNORE_CONTROL_FLOW)) {
         controlFlowEdge(source->id, destination->id, backEdge);
     }
 }
@@ -74,6 +87,8 @@ void Edges::printSubFunctionCallEdge(Node *source, Node *destination) {
 }
 
 void Edges::printSubFunctionCallEdge(Node *source, Node *destination, int order) {
+    graphGenerator->addBBEdge(source, destination);
+
     // put nodes with function call edges from external at the top of their subgraph
     if (source->getVariant() == NodeVariant::EXTERNAL) {
         output("subgraph cluster_" + destination->groupName + " {");
@@ -105,6 +120,11 @@ void Edges::printSubMemoryAddressEdge(Node *source, Node *destination) {
         printer.attributes["flowType"] = "address";
     }
 
+    // arrays don't carry a conflict count, so this is the access's
+    if (Edges::graphGenerator->checkArg(ADD_BANK_CONFLICTS)) {
+        printer.attributes["bankConflicts"] = std::to_string(std::max(source->bankConflicts, destination->bankConflicts));
+    }
+
     printer.print();
 }
 void Edges::printSubDataFlowEdge(Node *source, Node *destination) { printSubDataFlowEdge(source, destination, 0); }
@@ -127,4 +147,22 @@ void Edges::printPragmaEdge(Node *source, Node *destination, int order) {
     printer.print();
 }
 
+void Edges::printChannelEdge(Node *source, Node *destination) {
+    GNN::EdgePrinter printer(source->id, destination->id);
+    printer.attributes["color"] = "darkorange";
+    printer.attributes["style"] = "bold";
+    printer.attributes["flowType"] = "channel";
+
+    printer.print();
+}
+
+void Edges::printBankEdge(Node *source, Node *destination) {
+    GNN::EdgePrinter printer(source->id, destination->id);
+    printer.attributes["color"] = "aquamarine4";
+    printer.attributes["style"] = "dashed";
+    printer.attributes["flowType"] = "bank";
+
+    printer.print();
+}
+
 } // namespace GNN
\ No newline at end of file
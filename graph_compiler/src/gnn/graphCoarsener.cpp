@@ -0,0 +1,206 @@
+#include "graphCoarsener.h"
+#include "analysisUtils.h"
+#include "edgePrinter.h"
+#include "loopInfo.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <tuple>
+
+namespace {
+
+std::string format(double value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+std::string getEdgeColor(const std::string &flowType) {
+    if (flowType == "control") {
+        return "red";
+    } else if (flowType == "call") {
+        return "magenta";
+    } else if (flowType == "pragma") {
+        return "blue";
+    }
+    return "black";
+}
+
+} // namespace
+
+namespace GNN {
+
+GraphCoarsener::GraphCoarsener(GraphGenerator *graphGenerator, const std::string &level)
+    : graphGenerator(graphGenerator), level(level) {
+    if (level != "bb" && level != "loop" && level != "function") {
+        throw std::runtime_error("Unknown coarsening level: " + level + ", expected bb, loop or function");
+    }
+}
+
+// code outside every loop is grouped by function at the loop level
+std::string GraphCoarsener::getRegionKey(int bbID, int loopID, int functionID) {
+    if (level == "bb") {
+        return "bb" + std::to_string(bbID);
+    } else if (level == "loop" && loopID != -1) {
+        return "loop" + std::to_string(loopID);
+    }
+    return "function" + std::to_string(functionID);
+}
+
+GraphCoarsener::Region &GraphCoarsener::getRegion(int bbID, int loopID, int functionID) {
+    std::string key = getRegionKey(bbID, loopID, functionID);
+    if (!regions.count(key)) {
+        Region region;
+        region.id = regions.size();
+        region.loopID = level == "function" ? -1 : loopID;
+        region.functionID = functionID;
+        region.label = key;
+        if (level == "loop" && loopID != -1 && !graphGenerator->loops[loopID].label.empty()) {
+            region.label = graphGenerator->loops[loopID].label;
+        }
+        regions[key] = region;
+    }
+    return regions[key];
+}
+
+// print the full graph to nowhere, keeping a copy of it
+void GraphCoarsener::record(GraphRecorder &recorder) {
+    GraphRecorder *previousRecorder = graphGenerator->recorder;
+    graphGenerator->recorder = &recorder;
+
+    // nodes that aren't printed keep no id, so they can be left out of the regions
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        node->id = -1;
+    }
+
+    std::ostringstream discarded;
+    std::streambuf *coutbuf = std::cout.rdbuf(discarded.rdbuf());
+    try {
+        graphGenerator->printGraph();
+    } catch (...) {
+        std::cout.rdbuf(coutbuf);
+        graphGenerator->recorder = previousRecorder;
+        throw;
+    }
+    std::cout.rdbuf(coutbuf);
+    graphGenerator->recorder = previousRecorder;
+}
+
+void GraphCoarsener::addOperations() {
+    std::map<Node *, Node *> memoryElements = Analysis::getMemoryElements(graphGenerator);
+
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (node->id == -1) {
+            continue;
+        }
+        Region &region = getRegion(node->bbID, node->loopID, node->functionID);
+        region.maxBitwidth = std::max(region.maxBitwidth, Analysis::getBitwidth(node.get()));
+
+        std::string opKind = Analysis::getOpKind(node.get());
+        if (opKind.empty()) {
+            continue;
+        }
+        double copies = Analysis::getReplication(node.get());
+        if (memoryElements.count(node.get()) && (opKind == "Read" || opKind == "Write")) {
+            std::map<std::string, double> &accesses = opKind == "Read" ? region.reads : region.writes;
+            accesses[Analysis::getElementName(memoryElements[node.get()])] += copies;
+        } else {
+            region.ops[opKind] += copies;
+        }
+    }
+}
+
+void GraphCoarsener::printRegion(Region &region) {
+    std::map<std::string, std::string> attributes;
+    attributes["label"] = region.label + "\n" + std::to_string(region.numNodes) + " nodes";
+    attributes["shape"] = "box";
+    attributes["regionType"] = level;
+    attributes["numNodes"] = std::to_string(region.numNodes);
+    attributes["maxBitwidth"] = std::to_string(region.maxBitwidth);
+    attributes["functionID"] = std::to_string(region.functionID);
+    attributes["loopID"] = std::to_string(region.loopID);
+
+    if (region.loopID != -1) {
+        LoopInfo &loop = graphGenerator->loops[region.loopID];
+        attributes["tripcount"] = format(loop.getTripcount());
+        attributes["unroll"] = std::to_string(loop.unrollFactor);
+        attributes["pipelined"] = loop.pipelined ? "1" : "0";
+        attributes["loopDepth"] = std::to_string(loop.depth);
+    }
+
+    for (std::pair<const std::string, double> &op : region.ops) {
+        attributes["op_" + op.first] = format(op.second);
+    }
+    double reads = 0, writes = 0;
+    for (std::pair<const std::string, double> &read : region.reads) {
+        attributes["reads_" + read.first] = format(read.second);
+        reads += read.second;
+    }
+    for (std::pair<const std::string, double> &write : region.writes) {
+        attributes["writes_" + write.first] = format(write.second);
+        writes += write.second;
+    }
+    attributes["reads"] = format(reads);
+    attributes["writes"] = format(writes);
+
+    std::string out = "node" + std::to_string(region.id) + "[";
+    for (std::pair<const std::string, std::string> &attribute : attributes) {
+        out += attribute.first + "=\"" + attribute.second + "\" ";
+    }
+    out += "]";
+    std::cout << out << std::endl;
+}
+
+// edges inside a region disappear, edges between regions are merged per flow type
+void GraphCoarsener::printEdges(GraphRecorder &recorder) {
+    std::map<std::tuple<int, int, std::string>, int> edgeCounts;
+    for (GraphRecorder::RecordedEdge &edge : recorder.edges) {
+        GraphRecorder::Membership &source = recorder.membership[edge.id1];
+        GraphRecorder::Membership &destination = recorder.membership[edge.id2];
+        int sourceRegion = getRegion(source.bbID, source.loopID, source.functionID).id;
+        int destinationRegion = getRegion(destination.bbID, destination.loopID, destination.functionID).id;
+        if (sourceRegion != destinationRegion) {
+            edgeCounts[std::make_tuple(sourceRegion, destinationRegion, edge.attributes["flowType"])]++;
+        }
+    }
+
+    for (std::pair<const std::tuple<int, int, std::string>, int> &edgeCount : edgeCounts) {
+        EdgePrinter printer(std::get<0>(edgeCount.first), std::get<1>(edgeCount.first));
+        printer.attributes["flowType"] = std::get<2>(edgeCount.first);
+        printer.attributes["color"] = getEdgeColor(std::get<2>(edgeCount.first));
+        printer.attributes["count"] = std::to_string(edgeCount.second);
+        printer.print();
+    }
+}
+
+void GraphCoarsener::print() {
+    GraphRecorder recorder;
+    record(recorder);
+
+    regions.clear();
+    for (GraphRecorder::Membership &node : recorder.membership) {
+        getRegion(node.bbID, node.loopID, node.functionID).numNodes++;
+    }
+    addOperations();
+
+    std::cout << "digraph {" << std::endl;
+    std::cout << "newrank=\"true\";" << std::endl;
+    std::cout << "coarsening=\"" << level << "\";" << std::endl;
+    for (std::pair<const std::string, std::string> &attribute : recorder.graphAttributes) {
+        std::cout << attribute.first << "=\"" << attribute.second << "\";" << std::endl;
+    }
+
+    // in id order, so the dot file reads like the full graphs do
+    std::vector<Region *> ordered(regions.size());
+    for (std::pair<const std::string, Region> &region : regions) {
+        ordered[region.second.id] = &region.second;
+    }
+    for (Region *region : ordered) {
+        printRegion(*region);
+    }
+
+    printEdges(recorder);
+    std::cout << "}" << std::endl;
+}
+
+} // namespace GNN
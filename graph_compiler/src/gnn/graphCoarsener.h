@@ -0,0 +1,54 @@
+#ifndef GNN_GRAPH_COARSENER_H
+#define GNN_GRAPH_COARSENER_H
+
+#include "graphGenerator.h"
+#include "graphRecorder.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+
+// Prints the graph with each BB, loop or function collapsed into one supernode.
+// Supernodes carry the operations and memory accesses in them, weighted by unroll factor,
+// and the edges between regions are kept, merged per flow type with a count.
+class GraphCoarsener {
+  public:
+    // level is one of "bb", "loop" or "function"
+    GraphCoarsener(GraphGenerator *graphGenerator, const std::string &level);
+
+    void print();
+
+  private:
+    GraphGenerator *graphGenerator;
+    std::string level;
+
+    struct Region {
+        int id;
+        // shown on the supernode, loops go by their label but are told apart by id
+        std::string label;
+        int loopID = -1;
+        int functionID = 0;
+        int numNodes = 0;
+        int maxBitwidth = 0;
+        std::map<std::string, double> ops;
+        std::map<std::string, double> reads;
+        std::map<std::string, double> writes;
+    };
+    std::map<std::string, Region> regions;
+
+    std::string getRegionKey(int bbID, int loopID, int functionID);
+    Region &getRegion(int bbID, int loopID, int functionID);
+
+    void record(GraphRecorder &recorder);
+    void addOperations();
+    void printRegion(Region &region);
+    void printEdges(GraphRecorder &recorder);
+};
+
+} // namespace GNN
+
+#endif
@@ -1,11 +1,22 @@
 #include "graphGenerator.h"
 #include "../utility.h"
 #include "args.h"
+#include "bankConflictAnalysis.h"
+#include "burstAnalysis.h"
+#include "dataflowAnalysis.h"
+#include "deadNodeEliminator.h"
+#include "initiationIntervalEstimator.h"
+#include "latencyEstimator.h"
+#include "loopNestAnalysis.h"
 #include "nodeUtils.h"
+#include "rangeAnalysis.h"
+#include "resourceEstimator.h"
 #include "rose.h"
 #include <Rose/CommandLine.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace GNN {
 
@@ -18,13 +29,32 @@ GraphGenerator::GraphGenerator(Sawyer::CommandLine::ParserResult parserResult) {
             argMap[argName] = false;
         }
     }
+    runEstimates = parserResult.have(LOOP_TREE);
+    for (const std::string &arg :
+         {STATS, ADD_GRAPH_FEATURES, ADD_II, ADD_BANK_CONFLICTS, ADD_BURSTS, ADD_SCHEDULE, BANK_NODES}) {
+        runEstimates = runEstimates || argMap[arg];
+    }
 
     variableMapper = std::make_unique<VariableMapper>(this);
     pragmaParser = std::make_unique<PragmaParser>(this);
     derefTracker = std::make_unique<DerefTracker>();
+    constantFolder = std::make_unique<ConstantFolder>(this);
+    valueNumbering = std::make_unique<ValueNumbering>(this);
     astParser = std::make_unique<AstParser>(this);
 }
 
+void GraphGenerator::removeNode(Node *node) {
+    nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
+
+    // it was most likely just made, so look from the back
+    for (auto it = nodes_unq.rbegin(); it != nodes_unq.rend(); it++) {
+        if (it->get() == node) {
+            nodes_unq.erase(std::next(it).base());
+            return;
+        }
+    }
+}
+
 bool GraphGenerator::checkArg(const std::string &arg) {
     assert(argMap.count(arg));
     return argMap[arg];
@@ -36,6 +66,21 @@ void GraphGenerator::printGraph() {
     std::cout << "digraph {" << std::endl;
     std::cout << "newrank=\"true\";" << std::endl;
 
+    if (checkArg(ADD_GRAPH_FEATURES)) {
+        for (Stat &stat : stats) {
+            if (stat.graphFeature) {
+                std::cout << stat.name << "=\"" << stat.value << "\";" << std::endl;
+                if (recorder) {
+                    recorder->addGraphAttribute(stat.name, std::to_string(stat.value));
+                }
+            }
+        }
+    }
+
+    bbEdges.clear();
+    numBBs = 0;
+    membership.clear();
+
     std::vector<Node *> nodesFrozen = nodes;
 
     // node ID starts at 0
@@ -49,10 +94,53 @@ void GraphGenerator::printGraph() {
     for (Edge *edge : edgesFrozen) {
         edge->run();
     }
+
+    // the BB graph is only complete once every edge is printed,
+    // dot doesn't mind graph attributes coming last
+    if (checkArg(ADD_BB_GRAPH)) {
+        std::string sources, targets;
+        for (const std::pair<int, int> &bbEdge : bbEdges) {
+            sources += (sources.empty() ? "" : " ") + std::to_string(bbEdge.first);
+            targets += (targets.empty() ? "" : " ") + std::to_string(bbEdge.second);
+        }
+        std::cout << "numBBs=\"" << numBBs << "\";" << std::endl;
+        std::cout << "cfgSources=\"" << sources << "\";" << std::endl;
+        std::cout << "cfgTargets=\"" << targets << "\";" << std::endl;
+
+        // node ids count up from 0, so these line up with the nodes
+        std::string bbs, loopIDs, functionIDs;
+        for (GraphRecorder::Membership &node : membership) {
+            bbs += (bbs.empty() ? "" : " ") + std::to_string(node.bbID);
+            loopIDs += (loopIDs.empty() ? "" : " ") + std::to_string(node.loopID);
+            functionIDs += (functionIDs.empty() ? "" : " ") + std::to_string(node.functionID);
+        }
+        std::cout << "nodeBBs=\"" << bbs << "\";" << std::endl;
+        std::cout << "nodeLoops=\"" << loopIDs << "\";" << std::endl;
+        std::cout << "nodeFunctions=\"" << functionIDs << "\";" << std::endl;
+    }
+    if (recorder) {
+        recorder->bbEdges.assign(bbEdges.begin(), bbEdges.end());
+        recorder->numBBs = numBBs;
+        recorder->membership = membership;
+    }
     // close the directed graph
     std::cout << "}" << std::endl;
 }
 
+void GraphGenerator::addPrintedNode(Node *node) {
+    if (node->id >= membership.size()) {
+        membership.resize(node->id + 1);
+    }
+    membership[node->id] = {node->bbID, node->loopID, node->functionID};
+    numBBs = std::max(numBBs, node->bbID + 1);
+}
+
+void GraphGenerator::addBBEdge(Node *source, Node *destination) {
+    if (source->bbID != destination->bbID) {
+        bbEdges.insert(std::make_pair(source->bbID, destination->bbID));
+    }
+}
+
 std::string GraphGenerator::getGroupName() {
     if (stateNode) {
         return stateNode->groupName;
@@ -102,6 +190,92 @@ void GraphGenerator::setFuncDec(SgFunctionDeclaration *funcDec){
     this->funcDec = funcDec;
 }
 
+int GraphGenerator::getLoopID() {
+    if (stateNode) {
+        return stateNode->loopID;
+    }
+    if (loopStack.empty()) {
+        return -1;
+    }
+    return loopStack.top();
+}
+
+int GraphGenerator::enterLoop(const std::string &label) {
+    LoopInfo loop;
+    loop.id = loops.size();
+    loop.parent = getLoopID();
+    loop.depth = loop.parent == -1 ? 0 : loops[loop.parent].depth + 1;
+    loop.label = label.empty() ? "loop" + std::to_string(loop.id) : label;
+    loop.funcDec = getFuncDec();
+    loop.dataflowStage = getDataflowStage();
+    loops.push_back(loop);
+
+    loopStack.push(loop.id);
+    return loop.id;
+}
+
+void GraphGenerator::exitLoop() {
+    assert(!loopStack.empty());
+    loopStack.pop();
+}
+
+int GraphGenerator::getControlLoopID(int loopID) {
+    if (loopID == -1) {
+        return -1;
+    }
+    if (loops[loopID].flattenedInto != -1) {
+        loopID = loops[loopID].flattenedInto;
+    }
+    if (loops[loopID].mergeGroup != -1) {
+        loopID = loops[loopID].mergeGroup;
+    }
+    return loopID;
+}
+
+int GraphGenerator::addDataflowRegion(int loopID) {
+    DataflowRegion region;
+    region.id = dataflowRegions.size();
+    region.loopID = loopID;
+    region.funcDec = getFuncDec();
+    region.parentStage = getDataflowStage();
+    dataflowRegions.push_back(region);
+    return region.id;
+}
+
+int GraphGenerator::getDataflowStage() {
+    if (stateNode) {
+        return stateNode->dataflowStage;
+    }
+    if (dataflowStageStack.empty()) {
+        return -1;
+    }
+    return dataflowStageStack.top();
+}
+
+void GraphGenerator::enterDataflowStage(int region, const std::string &label, SgFunctionDeclaration *callee) {
+    DataflowStage stage;
+    stage.id = dataflowStages.size();
+    stage.region = region;
+    stage.label = label;
+    stage.callee = callee;
+    dataflowStages.push_back(stage);
+    dataflowRegions[region].stages.push_back(stage.id);
+
+    dataflowStageStack.push(stage.id);
+}
+
+void GraphGenerator::exitDataflowStage() {
+    assert(!dataflowStageStack.empty());
+    dataflowStageStack.pop();
+}
+
+int GraphGenerator::getStageInRegion(int stage, int region) {
+    while (stage != -1 && dataflowStages[stage].region != region) {
+        stage = dataflowRegions[dataflowStages[stage].region].parentStage;
+    }
+    return stage;
+}
+
 void GraphGenerator::registerCalls(SgFunctionDeclaration *funcDec, int unrollFactor){
     if(!funcDecsToCallNums.count(funcDec)){
         funcDecsToCallNums[funcDec] = unrollFactor;
@@ -121,10 +295,65 @@ int GraphGenerator::getCallSiteNums(SgFunctionDeclaration *funcDec){
     return funcDecsToCallSiteNums[funcDec];
 }
 
+void GraphGenerator::addStat(const std::string &name, double value, bool graphFeature) {
+    stats.push_back({name, value, graphFeature});
+}
+
+void GraphGenerator::printStats() {
+    std::cerr << "Stats:" << std::endl;
+    for (Stat &stat : stats) {
+        std::cerr << stat.name << ": " << stat.value << std::endl;
+    }
+    if (!reports.empty()) {
+        std::cerr << "Report:" << std::endl;
+        for (std::string &line : reports) {
+            std::cerr << line << std::endl;
+        }
+    }
+}
+
+void GraphGenerator::addReport(const std::string &line) { reports.push_back(line); }
+
+// analysis passes over the finished graph,
+// they run before printing so they can annotate nodes
+void GraphGenerator::runAnalyses() {
+    stats.clear();
+    reports.clear();
+
+    addStat("foldedOps", constantFolder->numFolded, false);
+    addStat("removedConstants", constantFolder->numRemoved, false);
+    addStat("mergedNodes", valueNumbering->numMerged, false);
+
+    if (checkArg(ELIMINATE_DEAD_NODES)) {
+        DeadNodeEliminator(this).run();
+    }
+    // the cost estimates use the narrowed bitwidths
+    if (checkArg(RANGE_BITWIDTH)) {
+        RangeAnalysis(this).run();
+    }
+    // flattening and merging change which nodes are printed as pipelined, so this always runs
+    LoopNestAnalysis(this).run();
+    if (!runEstimates) {
+        return;
+    }
+    DataflowAnalysis(this).run();
+
+    ResourceEstimator(this).run();
+    // the II needs the bank conflicts, and latency needs the II of pipelined loops
+    BankConflictAnalysis(this).run();
+    BurstAnalysis(this).run();
+    InitiationIntervalEstimator(this).run();
+    LatencyEstimator(this).run();
+}
+
 void GraphGenerator::generateGraph(SgFunctionDefinition *topLevelFuncDef) {
     Edges::graphGenerator = this;
     Nodes::graphGenerator = this;
+    // the AST can be walked more than once per process
+    Edges::resetPreviousControlFlowNode();
     astParser->parseAst(topLevelFuncDef);
+
+    runAnalyses();
 }
 
 } // namespace GNN
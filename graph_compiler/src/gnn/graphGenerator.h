@@ -2,14 +2,21 @@
 #define GNN_GRAPH_GENERATOR_H
 
 #include "astParser.h"
+#include "constantFolder.h"
+#include "dataflowInfo.h"
 #include "derefTracker.h"
 #include "edge.h"
+#include "graphRecorder.h"
+#include "loopInfo.h"
 #include "node.h"
 #include "pragmaParser.h"
 #include "rose.h"
+#include "valueNumbering.h"
 #include "variableMapper.h"
 #include <memory>
 #include <queue>
+#include <set>
+#include <stack>
 #include <unordered_set>
 
 namespace GNN {
@@ -18,6 +25,8 @@ class VariableMapper;
 class PragmaParser;
 class DerefTracker;
 class AstParser;
+class ConstantFolder;
+class ValueNumbering;
 
 class Node;
 class Edge;
@@ -32,13 +41,24 @@ class GraphGenerator {
     std::unique_ptr<VariableMapper> variableMapper;
     std::unique_ptr<PragmaParser> pragmaParser;
     std::unique_ptr<DerefTracker> derefTracker;
+    std::unique_ptr<ConstantFolder> constantFolder;
+    std::unique_ptr<ValueNumbering> valueNumbering;
     std::unique_ptr<AstParser> astParser;
 
     std::vector<Node *> nodes;
     std::vector<std::unique_ptr<Node>> nodes_unq;
 
+    // takes a node that nothing uses back out of the graph
+    void removeNode(Node *node);
+
     std::vector<Edge *> edges;
     std::vector<std::unique_ptr<Edge>> edges_unq;
+    // every node an edge was made with, so the constant folder can tell a constant is used without a scan
+    std::unordered_set<Node *> edgeNodes;
+
+    // taken out of the graph by --eliminate_dead_nodes, kept allocated as live nodes can still point at them
+    std::vector<std::unique_ptr<Node>> removedNodes;
+    std::vector<std::unique_ptr<Edge>> removedEdges;
 
     bool checkArg(const std::string &arg);
 
@@ -55,14 +75,73 @@ class GraphGenerator {
     SgFunctionDeclaration *getFuncDec();
     void setFuncDec(SgFunctionDeclaration *funcDec);
 
+    // every loop in the kernel, indexed by loopID
+    std::vector<LoopInfo> loops;
+
+    int getLoopID();
+    int enterLoop(const std::string &label);
+    void exitLoop();
+    // the loop whose control a loop runs under once flattened or merged, itself otherwise
+    int getControlLoopID(int loopID);
+
+    // functions whose body has a LOOP_MERGE pragma
+    std::set<SgFunctionDeclaration *> loopMergeFunctions;
+
+    // DATAFLOW regions and their stages, indexed by id
+    std::vector<DataflowRegion> dataflowRegions;
+    std::vector<DataflowStage> dataflowStages;
+    // found by the dataflow analysis
+    std::vector<DataflowChannel> dataflowChannels;
+
+    int addDataflowRegion(int loopID);
+    int getDataflowStage();
+    void enterDataflowStage(int region, const std::string &label, SgFunctionDeclaration *callee);
+    void exitDataflowStage();
+    // the stage of a region that a stage is, or is nested in, -1 if it isn't in the region
+    int getStageInRegion(int stage, int region);
+
     Node *stateNode = nullptr;
 
+    // when set, printed nodes and edges are also recorded here
+    GraphRecorder *recorder = nullptr;
+
+    // control flow between BBs, found as control flow edges are printed
+    std::set<std::pair<int, int>> bbEdges;
+    int numBBs = 0;
+    void addBBEdge(Node *source, Node *destination);
+
+    // the BB, loop and function of each printed node, indexed by node id
+    std::vector<GraphRecorder::Membership> membership;
+    void addPrintedNode(Node *node);
+
     void registerCalls(SgFunctionDeclaration *funcDec, int unrollFactor);
 
     int getCallsNums(SgFunctionDeclaration *funcDec);
     int getCallSiteNums(SgFunctionDeclaration *funcDec);
 
+    // results of the analysis passes, printed with --stats
+    // graph features are also added to the graph with --add_graph_features
+    struct Stat {
+        std::string name;
+        double value;
+        bool graphFeature;
+    };
+    std::vector<Stat> stats;
+
+    void addStat(const std::string &name, double value, bool graphFeature);
+    void printStats();
+
+    // the estimates are only worked out when something reads them,
+    // set from the arguments, callers that only want the estimates can set it themselves
+    bool runEstimates;
+
+    // longer explanations from the analysis passes, printed after the stats
+    std::vector<std::string> reports;
+    void addReport(const std::string &line);
+
   private:
+    void runAnalyses();
+
     // used to specify which function a node belongs to
     // for grouping on pdf
     std::string groupName;
@@ -73,6 +152,9 @@ class GraphGenerator {
 
     bool bbEmpty = true;
 
+    std::stack<int> loopStack;
+    std::stack<int> dataflowStageStack;
+
     SgFunctionDeclaration *funcDec = nullptr;
 
     std::map<SgFunctionDeclaration *, int> funcDecsToCallNums;
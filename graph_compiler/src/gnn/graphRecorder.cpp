@@ -0,0 +1,29 @@
+#include "graphRecorder.h"
+
+namespace GNN {
+
+void GraphRecorder::addNode(int id, const std::map<std::string, std::string> &attributes) {
+    if (id >= nodes.size()) {
+        nodes.resize(id + 1);
+    }
+    nodes[id] = attributes;
+}
+
+void GraphRecorder::addEdge(int id1, int id2, const std::map<std::string, std::string> &attributes) {
+    edges.push_back({id1, id2, attributes});
+}
+
+void GraphRecorder::addGraphAttribute(const std::string &name, const std::string &value) {
+    graphAttributes[name] = value;
+}
+
+void GraphRecorder::clear() {
+    nodes.clear();
+    edges.clear();
+    graphAttributes.clear();
+    membership.clear();
+    bbEdges.clear();
+    numBBs = 0;
+}
+
+} // namespace GNN
@@ -0,0 +1,42 @@
+#ifndef GNN_GRAPH_RECORDER_H
+#define GNN_GRAPH_RECORDER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+// Keeps a copy of everything printed to the dot file,
+// so the graph can be used in-process without parsing the dot text back in
+class GraphRecorder {
+  public:
+    struct RecordedEdge {
+        int id1, id2;
+        std::map<std::string, std::string> attributes;
+    };
+
+    // indexed by node id, as nodes are printed in id order
+    std::vector<std::map<std::string, std::string>> nodes;
+    std::vector<RecordedEdge> edges;
+    std::map<std::string, std::string> graphAttributes;
+
+    // the BB, loop and function each node is in, indexed by node id
+    struct Membership {
+        int bbID, loopID, functionID;
+    };
+    std::vector<Membership> membership;
+
+    // control flow between BBs, and the number of BBs (the largest bbID + 1)
+    std::vector<std::pair<int, int>> bbEdges;
+    int numBBs = 0;
+
+    void addGraphAttribute(const std::string &name, const std::string &value);
+    void addNode(int id, const std::map<std::string, std::string> &attributes);
+    void addEdge(int id1, int id2, const std::map<std::string, std::string> &attributes);
+    void clear();
+};
+
+} // namespace GNN
+
+#endif
@@ -0,0 +1,187 @@
+#include "initiationIntervalEstimator.h"
+#include "analysisUtils.h"
+#include "latencyEstimator.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace GNN {
+
+InitiationIntervalEstimator::InitiationIntervalEstimator(GraphGenerator *graphGenerator)
+    : graphGenerator(graphGenerator) {
+    predecessors = Analysis::getDataflowPredecessors(graphGenerator);
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+}
+
+bool InitiationIntervalEstimator::isInLoop(int nodeLoopID, int loopID) {
+    while (nodeLoopID != -1) {
+        if (nodeLoopID == loopID) {
+            return true;
+        }
+        nodeLoopID = graphGenerator->loops[nodeLoopID].parent;
+    }
+    return false;
+}
+
+// loops inside a pipelined loop are unrolled into it, so they don't get their own II
+bool InitiationIntervalEstimator::isInsidePipeline(LoopInfo &loop) {
+    for (int parent = loop.parent; parent != -1; parent = graphGenerator->loops[parent].parent) {
+        if (graphGenerator->loops[parent].pipelined) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// nodes in the loop or any loop inside it, in the order they were made
+std::vector<Node *> InitiationIntervalEstimator::getLoopNodes(int loopID) {
+    std::vector<Node *> loopNodes;
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (isInLoop(node->loopID, loopID)) {
+            loopNodes.push_back(node.get());
+        }
+    }
+    return loopNodes;
+}
+
+// cycles from the start of one operation to the end of another along dataflow,
+// 0 if there's no path between them
+double InitiationIntervalEstimator::getPathLatency(std::vector<Node *> &loopNodes, Node *from, Node *to) {
+    std::map<Node *, double> finish;
+    for (Node *node : loopNodes) {
+        Node *element = memoryElements.count(node) ? memoryElements[node] : nullptr;
+        if (node == from) {
+            finish[node] = getOperationLatency(node, element);
+            continue;
+        }
+        if (!predecessors.count(node)) {
+            continue;
+        }
+        for (Node *predecessor : predecessors[node]) {
+            if (finish.count(predecessor)) {
+                double latency = finish[predecessor] + getOperationLatency(node, element);
+                finish[node] = std::max(finish[node], latency);
+            }
+        }
+    }
+    return finish.count(to) ? finish[to] : 0;
+}
+
+// does a node's value come from reading the memory element
+bool InitiationIntervalEstimator::dependsOn(Node *node, Node *memoryElement) {
+    std::set<Node *> visited;
+    std::vector<Node *> toVisit = {node};
+    while (!toVisit.empty()) {
+        Node *current = toVisit.back();
+        toVisit.pop_back();
+        if (visited.count(current)) {
+            continue;
+        }
+        visited.insert(current);
+
+        if (memoryElements.count(current) && memoryElements[current] == memoryElement) {
+            return true;
+        }
+        if (predecessors.count(current)) {
+            toVisit.insert(toVisit.end(), predecessors[current].begin(), predecessors[current].end());
+        }
+    }
+    return false;
+}
+
+double InitiationIntervalEstimator::getRecurrenceII(LoopInfo &loop, std::vector<Node *> &loopNodes) {
+    // reads and writes of each element, in order
+    std::map<Node *, std::vector<Node *>> accesses;
+    for (Node *node : loopNodes) {
+        if (memoryElements.count(node)) {
+            accesses[memoryElements[node]].push_back(node);
+        }
+    }
+
+    double recurrenceII = 1;
+    for (std::pair<Node *const, std::vector<Node *>> &elementAccesses : accesses) {
+        Node *element = elementAccesses.first;
+        std::vector<Node *> reads, writes;
+        for (Node *access : elementAccesses.second) {
+            if (dynamic_cast<WriteNode *>(access)) {
+                writes.push_back(access);
+            } else {
+                reads.push_back(access);
+            }
+        }
+        if (reads.empty() || writes.empty()) {
+            continue;
+        }
+
+        bool scalar = Analysis::isScalarElement(element);
+        // a scalar written before it's read is reset every iteration
+        if (scalar && dynamic_cast<WriteNode *>(elementAccesses.second.front())) {
+            continue;
+        }
+
+        for (Node *read : reads) {
+            for (Node *write : writes) {
+                if (!scalar) {
+                    // the same address, moving with the iterator, is a different element every iteration
+                    DerefNode *address = Analysis::getAddress(predecessors, read);
+                    bool sameAddress = address && address == Analysis::getAddress(predecessors, write);
+                    if (sameAddress && loop.iterator && dependsOn(address, loop.iterator)) {
+                        continue;
+                    }
+                }
+                recurrenceII = std::max(recurrenceII, getPathLatency(loopNodes, read, write));
+            }
+        }
+    }
+    return recurrenceII;
+}
+
+double InitiationIntervalEstimator::getResourceII(LoopInfo &loop, std::vector<Node *> &loopNodes) {
+    std::map<Node *, double> accessesPerIteration;
+    for (Node *node : loopNodes) {
+        if (memoryElements.count(node) && !Analysis::isScalarElement(memoryElements[node])) {
+            accessesPerIteration[memoryElements[node]] += Analysis::getReplication(node);
+        }
+    }
+
+    double resourceII = 1;
+    for (std::pair<Node *const, double> &accesses : accessesPerIteration) {
+        Node *array = accesses.first;
+        // assumes accesses are spread evenly over the banks
+        double accessesPerBank = std::ceil(accesses.second / Analysis::getNumBanks(array));
+        double ii = std::ceil(accessesPerBank / Analysis::getNumPorts(graphGenerator, array));
+        // unless the bank conflict analysis found where they actually go
+        if (loop.bankCycles.count(array)) {
+            ii = std::max(ii, loop.bankCycles[array]);
+        }
+        resourceII = std::max(resourceII, ii);
+    }
+    return resourceII;
+}
+
+void InitiationIntervalEstimator::run() {
+    for (LoopInfo &loop : graphGenerator->loops) {
+        if (!loop.pipelined || isInsidePipeline(loop)) {
+            continue;
+        }
+
+        std::vector<Node *> loopNodes = getLoopNodes(loop.id);
+        double recurrenceII = getRecurrenceII(loop, loopNodes);
+        double resourceII = getResourceII(loop, loopNodes);
+        // the tool schedules for the II asked for if it can meet it, and the best it can do otherwise
+        loop.ii = std::max({recurrenceII, resourceII, double(loop.targetII)});
+
+        // a flattened nest is all one pipeline
+        std::vector<Node *> pipelineNodes = loop.flattenedInto == -1 ? loopNodes : getLoopNodes(loop.flattenedInto);
+        for (Node *node : pipelineNodes) {
+            node->ii = int(loop.ii);
+        }
+
+        graphGenerator->addStat("recurrenceII_" + loop.getStatName(), recurrenceII, false);
+        graphGenerator->addStat("resourceII_" + loop.getStatName(), resourceII, false);
+        graphGenerator->addStat("targetII_" + loop.getStatName(), loop.targetII, false);
+        graphGenerator->addStat("ii_" + loop.getStatName(), loop.ii, false);
+    }
+}
+
+} // namespace GNN
@@ -0,0 +1,44 @@
+#ifndef GNN_INITIATION_INTERVAL_ESTIMATOR_H
+#define GNN_INITIATION_INTERVAL_ESTIMATOR_H
+
+#include "graphGenerator.h"
+#include "loopInfo.h"
+#include "node.h"
+#include <map>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+
+// Estimates the II each pipelined loop achieves.
+// The recurrence II is the latency around loop-carried dependencies through scalars and arrays,
+// the resource II is the accesses each array bank gets per iteration over its ports.
+// The loop's II is the larger of the two, or of the II its pragma asks for, and is set on the loop and all of its nodes.
+class InitiationIntervalEstimator {
+  public:
+    InitiationIntervalEstimator(GraphGenerator *graphGenerator);
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, std::vector<Node *>> predecessors;
+    std::map<Node *, Node *> memoryElements;
+
+    bool isInLoop(int nodeLoopID, int loopID);
+    bool isInsidePipeline(LoopInfo &loop);
+    std::vector<Node *> getLoopNodes(int loopID);
+
+    double getRecurrenceII(LoopInfo &loop, std::vector<Node *> &loopNodes);
+    double getResourceII(LoopInfo &loop, std::vector<Node *> &loopNodes);
+
+    double getPathLatency(std::vector<Node *> &loopNodes, Node *from, Node *to);
+    bool dependsOn(Node *node, Node *memoryElement);
+};
+
+} // namespace GNN
+
+#endif
@@ -0,0 +1,329 @@
+#include "latencyEstimator.h"
+#include "analysisUtils.h"
+#include "args.h"
+#include <algorithm>
+
+namespace {
+
+// single and double precision latencies of the floating point cores
+double floatLatency(const std::string &opKind, bool isDouble) {
+    if (opKind == "Addition" || opKind == "Subtraction") {
+        return isDouble ? 5 : 4;
+    } else if (opKind == "Multiplication") {
+        return isDouble ? 6 : 3;
+    } else if (opKind == "Division") {
+        return isDouble ? 31 : 10;
+    } else if (opKind == "CastToFloat") {
+        return isDouble ? 6 : 5;
+    } else if (opKind == "Comparison" || opKind == "Select") {
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+namespace GNN {
+
+double getOperationLatency(const std::string &opKind, int bitwidth, bool isFloat, bool constantOperand) {
+    if (isFloat) {
+        return floatLatency(opKind, bitwidth > 32);
+    }
+
+    if (opKind == "Multiplication") {
+        if (constantOperand) {
+            return 1;
+        }
+        return bitwidth <= 18 ? 2 : 3;
+    } else if (opKind == "Division") {
+        return bitwidth + 4;
+    } else if (opKind == "LeftShift" || opKind == "RightShift") {
+        return constantOperand ? 0 : 1;
+    } else if (opKind == "Addition" || opKind == "Subtraction" || opKind == "Comparison" || opKind == "BitAnd" ||
+               opKind == "BitXor" || opKind == "Or" || opKind == "Xor" || opKind == "Not" || opKind == "Select") {
+        return 1;
+    } else if (opKind == "CastToFloat") {
+        return floatLatency(opKind, bitwidth > 32);
+    } else if (opKind == "Read") {
+        return 2;
+    } else if (opKind == "Write") {
+        return 1;
+    }
+    return 0;
+}
+
+LatencyEstimator::LatencyEstimator(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    predecessors = Analysis::getDataflowPredecessors(graphGenerator);
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+
+    for (std::pair<SgFunctionDeclaration *const, std::vector<FunctionCallNode *>> &calls :
+         graphGenerator->astParser->decsToCalls) {
+        for (FunctionCallNode *call : calls.second) {
+            callees[call] = calls.first;
+        }
+    }
+
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (!Analysis::getOpKind(node.get()).empty()) {
+            bbOperations[std::make_pair(node->bbID, node->loopID)].push_back(node.get());
+        }
+    }
+}
+
+double getOperationLatency(Node *node, Node *memoryElement) {
+    std::string opKind = Analysis::getOpKind(node);
+
+    if (opKind == "Call") {
+        return 1;
+    }
+
+    if (opKind == "Read" || opKind == "Write") {
+        if (memoryElement && Analysis::isScalarElement(memoryElement)) {
+            return 0;
+        }
+    }
+
+    bool isFloat = Analysis::isFloat(node);
+    if (ComparisonNode *comparison = dynamic_cast<ComparisonNode *>(node)) {
+        if (comparison->binaryComp) {
+            isFloat = Analysis::isFloat(comparison->lhs) || Analysis::isFloat(comparison->rhs);
+        }
+    }
+    return getOperationLatency(opKind, Analysis::getBitwidth(node), isFloat, Analysis::hasConstantOperand(node));
+}
+
+double LatencyEstimator::getNodeLatency(Node *node) {
+    if (callees.count(node) && callees[node]->get_definition()) {
+        return getFunctionLatency(callees[node]);
+    }
+    return getOperationLatency(node, memoryElements.count(node) ? memoryElements[node] : nullptr);
+}
+
+// schedule the operations of one BB, setting asap and alap on each,
+// and return how many cycles it takes
+double LatencyEstimator::scheduleBB(std::vector<Node *> &operations) {
+    std::set<Node *> inBB(operations.begin(), operations.end());
+    std::map<Node *, double> latencies;
+    std::map<Node *, double> finish;
+    std::map<Node *, std::vector<Node *>> successors;
+
+    // reads wait for earlier writes to the same element in the BB
+    std::map<Node *, Node *> lastWrites;
+
+    double length = 0;
+    for (Node *node : operations) {
+        latencies[node] = getNodeLatency(node);
+
+        std::vector<Node *> dependencies;
+        if (predecessors.count(node)) {
+            dependencies = predecessors[node];
+        }
+        if (memoryElements.count(node)) {
+            Node *element = memoryElements[node];
+            if (dynamic_cast<WriteNode *>(node)) {
+                lastWrites[element] = node;
+            } else if (lastWrites.count(element)) {
+                dependencies.push_back(lastWrites[element]);
+            }
+        }
+
+        double start = 0;
+        for (Node *dependency : dependencies) {
+            if (inBB.count(dependency) && finish.count(dependency)) {
+                start = std::max(start, finish[dependency]);
+                successors[dependency].push_back(node);
+            }
+        }
+        node->asap = int(start);
+        finish[node] = start + latencies[node];
+        length = std::max(length, finish[node]);
+    }
+
+    for (auto node = operations.rbegin(); node != operations.rend(); node++) {
+        double latest = length;
+        for (Node *successor : successors[*node]) {
+            latest = std::min(latest, double(successor->alap));
+        }
+        (*node)->alap = int(latest - latencies[*node]);
+    }
+
+    // every BB takes at least a state
+    return std::max(length, 1.0);
+}
+
+// the BBs and loops directly inside a loop body, or a function body when loopID is -1
+// the stages of a dataflow region run at the same time, so the region takes as long as its slowest stage
+double LatencyEstimator::getBodyLatency(int loopID, SgFunctionDeclaration *funcDec, bool insidePipeline) {
+    DataflowRegion *region = nullptr;
+    for (DataflowRegion &candidate : graphGenerator->dataflowRegions) {
+        if (candidate.loopID == loopID && candidate.funcDec == funcDec) {
+            region = &candidate;
+        }
+    }
+
+    // latency outside of any stage is summed as usual
+    double latency = 0;
+    std::map<int, double> stageLatencies;
+    for (std::pair<const std::pair<int, int>, std::vector<Node *>> &bb : bbOperations) {
+        if (bb.first.second != loopID || bb.second.front()->funcDec != funcDec) {
+            continue;
+        }
+        if (!region) {
+            latency += scheduleBB(bb.second);
+            continue;
+        }
+
+        // a BB can hold several stages, each is scheduled on its own
+        std::map<int, std::vector<Node *>> stageOperations;
+        for (Node *node : bb.second) {
+            stageOperations[graphGenerator->getStageInRegion(node->dataflowStage, region->id)].push_back(node);
+        }
+        for (std::pair<const int, std::vector<Node *>> &stage : stageOperations) {
+            if (stage.first == -1) {
+                latency += scheduleBB(stage.second);
+            } else {
+                stageLatencies[stage.first] += scheduleBB(stage.second);
+            }
+        }
+    }
+
+    // each child loop, or group of merged child loops, with its latency
+    std::vector<std::pair<int, double>> childLatencies;
+    std::map<int, std::vector<int>> mergeGroups;
+    for (LoopInfo &child : graphGenerator->loops) {
+        bool inBody = loopID == -1 ? child.parent == -1 && child.funcDec == funcDec : child.parent == loopID;
+        if (!inBody) {
+            continue;
+        }
+        if (child.mergeGroup != -1 && !insidePipeline) {
+            mergeGroups[child.mergeGroup].push_back(child.id);
+        } else {
+            childLatencies.push_back(std::make_pair(child.id, getLoopLatency(child.id, insidePipeline)));
+        }
+    }
+    for (std::pair<const int, std::vector<int>> &group : mergeGroups) {
+        childLatencies.push_back(std::make_pair(group.first, getMergedLatency(group.second)));
+    }
+
+    for (std::pair<int, double> &child : childLatencies) {
+        int childStage = graphGenerator->loops[child.first].dataflowStage;
+        int stage = region ? graphGenerator->getStageInRegion(childStage, region->id) : -1;
+        if (stage == -1) {
+            latency += child.second;
+        } else {
+            stageLatencies[stage] += child.second;
+        }
+    }
+
+    if (region) {
+        double slowest = 0;
+        for (int stage : region->stages) {
+            graphGenerator->dataflowStages[stage].latency = stageLatencies[stage];
+            slowest = std::max(slowest, stageLatencies[stage]);
+        }
+        region->latency = slowest;
+        latency += slowest;
+    }
+    return latency;
+}
+
+// loops inside a pipelined loop are fully unrolled by the tool,
+// so they only add their body once
+double LatencyEstimator::getLoopLatency(int loopID, bool insidePipeline) {
+    LoopInfo &loop = graphGenerator->loops[loopID];
+    bool pipelined = loop.pipelined && !insidePipeline;
+    double iterations = loop.getIterations();
+    double ii = loop.ii;
+
+    // a nest flattened into a pipelined loop is one pipeline over the iterations of all of its loops
+    if (!pipelined && !insidePipeline) {
+        for (LoopInfo &inner : graphGenerator->loops) {
+            if (inner.flattenedInto == loopID && inner.pipelined) {
+                pipelined = true;
+                ii = inner.ii;
+            }
+        }
+        if (pipelined) {
+            for (LoopInfo &inner : graphGenerator->loops) {
+                if (inner.flattenedInto == loopID) {
+                    iterations *= inner.getIterations();
+                }
+            }
+        }
+    }
+
+    double body = getBodyLatency(loopID, loop.funcDec, insidePipeline || pipelined);
+    loop.iterationLatency = body;
+
+    if (insidePipeline) {
+        loop.latency = body;
+    } else if (pipelined) {
+        loop.latency = body + (iterations - 1) * ii;
+        // a rewound pipeline doesn't drain between entries, so only the first entry waits for its depth
+        if (loop.rewind) {
+            double entries = 1;
+            for (int parent = loop.parent; parent != -1; parent = graphGenerator->loops[parent].parent) {
+                entries *= graphGenerator->loops[parent].getIterations();
+            }
+            loop.latency = iterations * ii + (body - ii) / entries;
+        }
+    } else {
+        loop.latency = iterations * body;
+    }
+    return loop.latency;
+}
+
+// merged loops run as one loop, for as many iterations as the longest of them,
+// with each iteration running all of their bodies
+double LatencyEstimator::getMergedLatency(std::vector<int> &group) {
+    double iterations = 0;
+    double body = 0;
+    double ii = 1;
+    bool pipelined = true;
+    for (int loopID : group) {
+        getLoopLatency(loopID, false);
+        LoopInfo &loop = graphGenerator->loops[loopID];
+        iterations = std::max(iterations, loop.getIterations());
+        body += loop.iterationLatency;
+        ii = std::max(ii, loop.ii);
+        pipelined = pipelined && loop.pipelined;
+    }
+    if (pipelined) {
+        return body + (iterations - 1) * ii;
+    }
+    return iterations * body;
+}
+
+double LatencyEstimator::getFunctionLatency(SgFunctionDeclaration *funcDec) {
+    if (functionLatencies.count(funcDec)) {
+        return functionLatencies[funcDec];
+    }
+    if (functionsInProgress.count(funcDec)) {
+        throw std::runtime_error("Recursive functions can't be scheduled: " + funcDec->get_name());
+    }
+    functionsInProgress.insert(funcDec);
+
+    double latency = getBodyLatency(-1, funcDec, false);
+
+    functionsInProgress.erase(funcDec);
+    functionLatencies[funcDec] = latency;
+    return latency;
+}
+
+void LatencyEstimator::run() {
+    for (LoopInfo &loop : graphGenerator->loops) {
+        getFunctionLatency(loop.funcDec);
+    }
+    for (std::pair<const std::pair<int, int>, std::vector<Node *>> &bb : bbOperations) {
+        getFunctionLatency(bb.second.front()->funcDec);
+    }
+
+    for (LoopInfo &loop : graphGenerator->loops) {
+        graphGenerator->addStat("latency_" + loop.getStatName(), loop.latency, false);
+    }
+
+    SgFunctionDeclaration *top = graphGenerator->astParser->topLevelFuncDec;
+    graphGenerator->addStat("estLatency", top ? getFunctionLatency(top) : 0, true);
+}
+
+} // namespace GNN
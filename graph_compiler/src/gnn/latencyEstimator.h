@@ -0,0 +1,60 @@
+#ifndef GNN_LATENCY_ESTIMATOR_H
+#define GNN_LATENCY_ESTIMATOR_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include "rose.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+
+// Estimates the latency of a kernel in cycles from the graph.
+// Each BB is scheduled ASAP and ALAP over its dataflow,
+// BBs are summed into loops, loops are scaled by tripcount over unroll factor,
+// and pipelined loops take depth + (N-1)*II. A nest flattened into a pipeline takes N as the product
+// of their tripcounts, a rewound pipeline only pays its depth once, and merged loops run their bodies together.
+// The stages of a DATAFLOW region overlap, so the region takes as long as its slowest stage.
+class LatencyEstimator {
+  public:
+    LatencyEstimator(GraphGenerator *graphGenerator);
+
+    void run();
+
+    double getFunctionLatency(SgFunctionDeclaration *funcDec);
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, std::vector<Node *>> predecessors;
+    std::map<Node *, Node *> memoryElements;
+    std::map<Node *, SgFunctionDeclaration *> callees;
+
+    // operations grouped by (bbID, loopID), in the order they were made
+    std::map<std::pair<int, int>, std::vector<Node *>> bbOperations;
+
+    std::map<SgFunctionDeclaration *, double> functionLatencies;
+    std::set<SgFunctionDeclaration *> functionsInProgress;
+
+    double getNodeLatency(Node *node);
+    double scheduleBB(std::vector<Node *> &operations);
+    double getBodyLatency(int loopID, SgFunctionDeclaration *funcDec, bool insidePipeline);
+    double getLoopLatency(int loopID, bool insidePipeline);
+    double getMergedLatency(std::vector<int> &group);
+};
+
+// cycles a single operation takes
+double getOperationLatency(const std::string &opKind, int bitwidth, bool isFloat, bool constantOperand);
+
+// cycles an operation node takes, calls count as a single cycle
+// memoryElement is what a read or write accesses, nullptr otherwise
+double getOperationLatency(Node *node, Node *memoryElement);
+
+} // namespace GNN
+
+#endif
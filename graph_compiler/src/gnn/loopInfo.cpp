@@ -0,0 +1,47 @@
+#include "loopInfo.h"
+#include "node.h"
+#include <cmath>
+
+namespace GNN {
+
+double LoopInfo::getTripcount() {
+    if (pragmaTripcount > 0) {
+        return pragmaTripcount;
+    }
+    if (iterator && iterator->fixedSizeIterator && iterator->hasIteratorInit && iterator->bounds.size() >= 2) {
+        double boundsMin = iterator->bounds[0];
+        double boundsMax = iterator->bounds[0];
+        for (double bound : iterator->bounds) {
+            boundsMax = bound > boundsMax ? bound : boundsMax;
+            boundsMin = bound < boundsMin ? bound : boundsMin;
+        }
+        if (boundsMax > boundsMin) {
+            return boundsMax - boundsMin;
+        }
+    }
+    return 1;
+}
+
+// iterations left once the loop is unrolled
+double LoopInfo::getIterations() {
+    double tripcount = getTripcount();
+    if (unrollFactor > 1) {
+        return std::ceil(tripcount / unrollFactor);
+    }
+    return tripcount;
+}
+
+long LoopInfo::getLowerBound() {
+    if (iterator && iterator->fixedSizeIterator && iterator->hasIteratorInit && !iterator->bounds.empty()) {
+        double boundsMin = iterator->bounds[0];
+        for (double bound : iterator->bounds) {
+            boundsMin = bound < boundsMin ? bound : boundsMin;
+        }
+        return long(boundsMin);
+    }
+    return 0;
+}
+
+std::string LoopInfo::getStatName() { return label + "_" + std::to_string(id); }
+
+} // namespace GNN
@@ -0,0 +1,68 @@
+#ifndef GNN_LOOP_INFO_H
+#define GNN_LOOP_INFO_H
+
+#include "rose.h"
+#include <map>
+#include <string>
+
+namespace GNN {
+
+class LocalScalarNode;
+class Node;
+
+// A loop found while parsing the AST
+// nodes inside it (at any depth of its own BBs) have its id as their loopID
+struct LoopInfo {
+    int id;
+    // the enclosing loop, -1 if the loop is at the top of its function
+    int parent = -1;
+    int depth = 0;
+
+    std::string label;
+    SgFunctionDeclaration *funcDec = nullptr;
+
+    // nullptr for while loops
+    LocalScalarNode *iterator = nullptr;
+
+    // the avg from a tripcount pragma, 0 if there wasn't one
+    float pragmaTripcount = 0;
+    int unrollFactor = 1;
+    bool pipelined = false;
+    // the II= of the pipeline pragma, 0 if it didn't give one
+    int targetII = 0;
+    bool rewind = false;
+    // the body has a LOOP_FLATTEN pragma
+    bool flatten = false;
+    // the body is nothing but one loop, so the two can be flattened
+    bool perfectBody = false;
+    // the body has a LOOP_MERGE pragma, so the loops directly inside it are merged
+    bool merge = false;
+    // the body has a DATAFLOW pragma
+    bool dataflow = false;
+    // the dataflow stage the loop is in, -1 if it isn't in one
+    int dataflowStage = -1;
+
+    // filled in by the analysis passes
+    // the outermost loop of the nest this loop was flattened into, -1 if it wasn't flattened
+    int flattenedInto = -1;
+    // the first loop of the loops this one was merged with, -1 if it wasn't merged
+    int mergeGroup = -1;
+    double ii = 1;
+    double iterationLatency = 0;
+    double latency = 0;
+    // cycles the busiest bank of each array needs per iteration
+    std::map<Node *, double> bankCycles;
+
+    // tripcount pragmas take priority over constant iterator bounds
+    // loops with neither are assumed to run once
+    double getTripcount();
+    double getIterations();
+    // the iterator's first value, 0 if it isn't known
+    long getLowerBound();
+    // the label and id, labels repeat when a function is inlined twice or the user reuses one
+    std::string getStatName();
+};
+
+} // namespace GNN
+
+#endif
@@ -0,0 +1,92 @@
+#include "loopNestAnalysis.h"
+#include <set>
+
+namespace GNN {
+
+void LoopNestAnalysis::flatten(LoopInfo &loop) {
+    std::vector<LoopInfo> &loops = graphGenerator->loops;
+    int head = loop.id;
+    while (loops[head].parent != -1 && loops[loops[head].parent].perfectBody && !loops[loops[head].parent].pipelined) {
+        head = loops[head].parent;
+    }
+    if (head == loop.id) {
+        return;
+    }
+
+    double tripcount = 1;
+    std::set<int> nest;
+    for (int inner = loop.id; inner != loops[head].parent; inner = loops[inner].parent) {
+        if (inner != head) {
+            loops[inner].flattenedInto = head;
+        }
+        tripcount *= loops[inner].getTripcount();
+        nest.insert(inner);
+    }
+
+    if (loop.pipelined) {
+        for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+            if (nest.count(node->loopID)) {
+                node->pipelined = true;
+                node->targetII = loop.targetII;
+            }
+        }
+    }
+    graphGenerator->addStat("flattenedTripcount_" + loops[head].getStatName(), tripcount, false);
+    graphGenerator->addReport("flattened " + loop.label + " into " + loops[head].label + ", " +
+                              std::to_string(nest.size()) + " loops with " + std::to_string(int(tripcount)) +
+                              " iterations" + (loop.pipelined ? ", pipelined" : ""));
+}
+
+void LoopNestAnalysis::merge(std::vector<int> &children) {
+    if (children.size() < 2) {
+        return;
+    }
+    std::string labels;
+    for (int child : children) {
+        graphGenerator->loops[child].mergeGroup = children.front();
+        labels += (labels.empty() ? "" : ", ") + graphGenerator->loops[child].label;
+    }
+    graphGenerator->addReport("merged " + labels);
+}
+
+void LoopNestAnalysis::run() {
+    std::vector<LoopInfo> &loops = graphGenerator->loops;
+
+    for (LoopInfo &loop : loops) {
+        if (loop.flatten) {
+            flatten(loop);
+        }
+    }
+
+    for (LoopInfo &loop : loops) {
+        if (loop.merge) {
+            std::vector<int> children;
+            for (LoopInfo &child : loops) {
+                if (child.parent == loop.id) {
+                    children.push_back(child.id);
+                }
+            }
+            merge(children);
+        }
+    }
+    for (SgFunctionDeclaration *funcDec : graphGenerator->loopMergeFunctions) {
+        std::vector<int> children;
+        for (LoopInfo &child : loops) {
+            if (child.parent == -1 && child.funcDec == funcDec) {
+                children.push_back(child.id);
+            }
+        }
+        merge(children);
+    }
+
+    int flattenedLoops = 0;
+    int mergedLoops = 0;
+    for (LoopInfo &loop : loops) {
+        flattenedLoops += loop.flattenedInto != -1;
+        mergedLoops += loop.mergeGroup != -1;
+    }
+    graphGenerator->addStat("flattenedLoops", flattenedLoops, false);
+    graphGenerator->addStat("mergedLoops", mergedLoops, false);
+}
+
+} // namespace GNN
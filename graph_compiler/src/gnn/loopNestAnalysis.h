@@ -0,0 +1,33 @@
+#ifndef GNN_LOOP_NEST_ANALYSIS_H
+#define GNN_LOOP_NEST_ANALYSIS_H
+
+#include "graphGenerator.h"
+#include "loopInfo.h"
+#include "node.h"
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+
+// Works out which loops LOOP_FLATTEN and LOOP_MERGE pragmas combine.
+// A flattened loop takes every loop above it whose body is nothing but the loop below,
+// and if it's pipelined the whole nest becomes that pipeline, running for the product of their tripcounts.
+// Merging joins the loops directly inside a loop or function body into one loop with one control region.
+// The II and latency estimates use what it finds, the nodes only take the pipeline marking.
+class LoopNestAnalysis {
+  public:
+    LoopNestAnalysis(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {}
+
+    void run();
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    void flatten(LoopInfo &loop);
+    void merge(std::vector<int> &children);
+};
+
+} // namespace GNN
+
+#endif
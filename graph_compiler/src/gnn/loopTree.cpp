@@ -0,0 +1,94 @@
+#include "loopTree.h"
+#include "analysisUtils.h"
+#include "loopInfo.h"
+#include "node.h"
+#include <map>
+#include <sstream>
+
+namespace {
+
+std::string quote(const std::string &text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string toJson(const std::map<std::string, int> &counts) {
+    std::string out = "{";
+    for (const std::pair<const std::string, int> &count : counts) {
+        if (out.size() > 1) {
+            out += ", ";
+        }
+        out += quote(count.first) + ": " + std::to_string(count.second);
+    }
+    return out + "}";
+}
+
+// what's directly in the body of a loop
+struct LoopBody {
+    std::map<std::string, int> ops;
+    std::map<std::string, int> reads;
+    std::map<std::string, int> writes;
+};
+
+} // namespace
+
+namespace GNN {
+
+void printLoopTree(GraphGenerator *graphGenerator, std::ostream &out) {
+    std::map<Node *, Node *> memoryElements = Analysis::getMemoryElements(graphGenerator);
+
+    // -1 holds everything outside the loops
+    std::map<int, LoopBody> bodies;
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        std::string opKind = Analysis::getOpKind(node.get());
+        if (opKind.empty()) {
+            continue;
+        }
+        LoopBody &body = bodies[node->loopID];
+        if (memoryElements.count(node.get()) && (opKind == "Read" || opKind == "Write")) {
+            std::map<std::string, int> &accesses = opKind == "Read" ? body.reads : body.writes;
+            accesses[Analysis::getElementName(memoryElements[node.get()])]++;
+        } else {
+            body.ops[opKind]++;
+        }
+    }
+
+    out << "{" << std::endl;
+    out << "  \"top\": {\"ops\": " << toJson(bodies[-1].ops) << ", \"reads\": " << toJson(bodies[-1].reads)
+        << ", \"writes\": " << toJson(bodies[-1].writes) << "}," << std::endl;
+    out << "  \"loops\": [";
+    for (LoopInfo &loop : graphGenerator->loops) {
+        out << (loop.id == 0 ? "" : ",") << std::endl;
+
+        std::string iterator = loop.iterator ? quote(loop.iterator->description) : "null";
+        bool fixedBounds = loop.iterator && loop.iterator->fixedSizeIterator && loop.iterator->hasIteratorInit;
+        std::ostringstream bounds;
+        bounds << "[";
+        if (loop.iterator) {
+            for (int i = 0; i < loop.iterator->bounds.size(); i++) {
+                bounds << (i == 0 ? "" : ", ") << loop.iterator->bounds[i];
+            }
+        }
+        bounds << "]";
+        std::string function = loop.funcDec ? std::string(loop.funcDec->get_name()) : "";
+
+        LoopBody &body = bodies[loop.id];
+        out << "    {\"id\": " << loop.id << ", \"label\": " << quote(loop.label) << ", \"parent\": " << loop.parent
+            << ", \"depth\": " << loop.depth << ", \"function\": " << quote(function) << ", \"iterator\": " << iterator
+            << ", \"bounds\": " << bounds.str() << ", \"fixedBounds\": " << (fixedBounds ? "true" : "false")
+            << ", \"tripcount\": " << loop.getTripcount() << ", \"unroll\": " << loop.unrollFactor
+            << ", \"pipelined\": " << (loop.pipelined ? "true" : "false") << ", \"ii\": " << loop.ii
+            << ", \"iterationLatency\": " << loop.iterationLatency << ", \"latency\": " << loop.latency
+            << ", \"ops\": " << toJson(body.ops) << ", \"reads\": " << toJson(body.reads)
+            << ", \"writes\": " << toJson(body.writes) << "}";
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+} // namespace GNN
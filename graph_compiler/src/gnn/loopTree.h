@@ -0,0 +1,19 @@
+#ifndef GNN_LOOP_TREE_H
+#define GNN_LOOP_TREE_H
+
+#include "graphGenerator.h"
+#include <ostream>
+
+namespace GNN {
+
+class GraphGenerator;
+
+// Writes the loop nest as JSON, one entry per loop with its parent, iterator bounds, pragmas,
+// the analysis results, and the operations and memory accesses directly in its body.
+// Operations in nested loops are only counted in the innermost loop, so sum over children for totals.
+// Operations outside every loop are under "top".
+void printLoopTree(GraphGenerator *graphGenerator, std::ostream &out);
+
+} // namespace GNN
+
+#endif
@@ -44,6 +44,16 @@ void Nodes::setNodeID(Node *node) {
 
 void Nodes::resetNodeID() { nodeID = 0; }
 
+TypeStruct Node::getRangeSextType() {
+    TypeStruct type = getSextType();
+    if (rangeBitwidth > 0 && !type.stringOverride && type.dataType == DataType::INTEGER &&
+        rangeBitwidth < type.bitwidth) {
+        type.bitwidth = rangeBitwidth;
+        type.isUnsigned = rangeUnsigned;
+    }
+    return type;
+}
+
 Node::Node() {
     std::cerr << "add node" << std::endl;
 
@@ -55,6 +65,7 @@ Node::Node() {
     groupName = Nodes::graphGenerator->getGroupName();
     pipelined = Nodes::graphGenerator->pragmaParser->getPipelined();
     previouslyPipelined = Nodes::graphGenerator->pragmaParser->getPreviouslyPipelined();
+    targetII = Nodes::graphGenerator->pragmaParser->getTargetII();
 
     if(!previouslyPipelined){
         unrollFactor = Nodes::graphGenerator->pragmaParser->getUnrollFactor();
@@ -79,6 +90,8 @@ Node::Node() {
 
     bbID = Nodes::graphGenerator->getBBID();
     functionID = Nodes::graphGenerator->getFunctionID();
+    loopID = Nodes::graphGenerator->getLoopID();
+    dataflowStage = Nodes::graphGenerator->getDataflowStage();
 
     // Add to raw pointer vector for actually use
     Nodes::graphGenerator->nodes.push_back(this);
@@ -329,6 +342,28 @@ void DerefNode::print() {
     printer.print();
 }
 
+bool DerefNode::isAffine() {
+    for (AffineIndex &index : indices) {
+        if (!index.affine) {
+            return false;
+        }
+    }
+    return !indices.empty();
+}
+
+std::string AffineIndex::toString() {
+    if (!affine) {
+        return "?";
+    }
+    std::string out;
+    for (std::pair<const int, long> &coefficient : coefficients) {
+        if (coefficient.second != 0) {
+            out += std::to_string(coefficient.second) + "*i" + std::to_string(coefficient.first) + " + ";
+        }
+    }
+    return out + std::to_string(constant);
+}
+
 void DerefNode::setType(TypeStruct typeDesc) {
     isTypeSet = true;
     type = typeDesc;
@@ -617,6 +652,26 @@ void ExternalArrayNode::print() {
     printer.print();
 }
 
+void MemoryBankNode::print() {
+    Nodes::setNodeID(this);
+
+    std::string label = "Memory Bank: " + variableName;
+    for (long index : bank) {
+        label += "[" + std::to_string(index) + "]";
+    }
+
+    NodePrinter printer(this, "0.33 0.1 1");
+    printer.attributes["label"] = label;
+    printer.attributes["keyText"] = "memoryBank";
+
+    if (!Nodes::graphGenerator->checkArg(ONE_HOT_TYPES)) {
+        assert(Nodes::graphGenerator->checkArg(ABSORB_TYPES));
+        printer.attributes["arrayWidth"] = std::to_string(numElements);
+    }
+
+    printer.print();
+}
+
 void FunctionCallNode::print() {
     if (!Nodes::graphGenerator->checkArg(INLINE_FUNCTIONS)) {
         Nodes::setNodeID(this);
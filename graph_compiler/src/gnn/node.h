@@ -6,6 +6,7 @@
 #include "nodePrinter.h"
 #include "nodeUtils.h"
 #include "rose.h"
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -72,7 +73,8 @@ enum class NodeVariant {
     STRUCT,
     COMPARISON,
     ARITHMETIC,
-    GLOBAL_ARRAY
+    GLOBAL_ARRAY,
+    MEMORY_BANK
 };
 
 enum class DataType { INTEGER, FLOAT };
@@ -118,6 +120,26 @@ struct StackedFactor {
   float third;
 };
 
+// an array index as constant + sum of coefficient * iterator,
+// with the iterators given by the id of the loop they belong to
+struct AffineIndex {
+    bool affine = true;
+    std::map<int, long> coefficients;
+    long constant = 0;
+
+    std::string toString();
+};
+
+// the settings of an INTERFACE m_axi pragma, the rest are the tool's defaults
+struct AxiInterface {
+    std::string bundle;
+    int depth = 0;
+    int maxReadBurstLength = 16;
+    int maxWriteBurstLength = 16;
+    // widest the port can be made to pack sequential accesses together, 0 if it isn't widened
+    int maxWidenBitwidth = 0;
+};
+
 //-------------------------------------------
 //       Base Types to Inherit From
 //-------------------------------------------
@@ -141,6 +163,8 @@ class Node {
     virtual TypeStruct getImmediateType() { return getType(); }
     virtual TypeStruct getSextType() { return getImmediateType(); }
     virtual TypeStruct getOutputType() { return getImmediateType(); }
+    // the sext type narrowed to the range --range_bitwidth found, if it found one
+    TypeStruct getRangeSextType();
 
     StackedFactor unrollFactor;
 
@@ -148,7 +172,8 @@ class Node {
 
     std::string groupName;
 
-    int id;
+    // set when printed
+    int id = -1;
     int partitionFactor1 = 0;
     int partitionFactor2 = 0;
     StackedFactor tripcount;
@@ -157,6 +182,37 @@ class Node {
 
     int bbID;
     int functionID;
+    // innermost loop the node is in, -1 if it isn't in one
+    int loopID = -1;
+    // innermost dataflow stage the node is in, -1 if it isn't in one
+    int dataflowStage = -1;
+
+    // earliest and latest cycle the node can start in its BB
+    int asap = 0;
+    int alap = 0;
+
+    // II of the pipelined loop the node is in, 0 if it isn't pipelined
+    int ii = 0;
+    // II the pipeline pragma the node is under asked for, 0 if it didn't give one
+    int targetII = 0;
+
+    // extra cycles the bank a memory access uses is busy for, 0 if there's no conflict
+    int bankConflicts = 0;
+
+    // elements a memory access walks through in order, across the loops around it, 1 if it doesn't
+    int sequentialRun = 0;
+    // elements each access gets at once from a reshaped array or widened m_axi port
+    int widenFactor = 0;
+    // words in each m_axi burst the access is part of, 0 if it isn't burst
+    int burstLength = 0;
+
+    // banks of a partitioned array a memory access or its address can reach, with --bank_nodes
+    std::vector<Node *> memoryBanks;
+
+    // fewest bits the node's values fit in, from --range_bitwidth, 0 if they don't fit in fewer than its type
+    // arithmetic and comparisons count their operands too, addresses count the offset into their bank
+    int rangeBitwidth = 0;
+    bool rangeUnsigned = false;
 
     std::string extraNote = "";
 
@@ -166,6 +222,11 @@ class Node {
 
     std::string partitionType1 = "none";
     std::string partitionType2 = "none";
+
+    // from an ARRAY_RESHAPE pragma, the dimension is counted from 1
+    std::string reshapeType = "none";
+    int reshapeFactor = 0;
+    int reshapeDim = 0;
     bool inlined = false;
 
 
@@ -197,6 +258,10 @@ class ConstantNode : public Node {
     }
     double getValue() {
         try {
+            // boolean literals are labelled "Bool: 0" or "Bool: 1"
+            if (value.rfind("Bool: ", 0) == 0) {
+                return std::stod(value.substr(6));
+            }
             return std::stod(value);
         } catch (...) {
             throw std::runtime_error("Tried to get int from non-numerical constant");
@@ -270,6 +335,10 @@ class DerefNode : public Node {
     Node *typeDependency = nullptr;
     Node *baseTypeDependency = nullptr;
 
+    // index of each dimension accessed, outermost first
+    std::vector<AffineIndex> indices;
+    bool isAffine();
+
     void setType(TypeStruct typeDesc) override;
 
     TypeStruct getType();
@@ -338,6 +407,10 @@ class LocalArrayNode : public Node {
 
     int numElements = 1;
 
+    // size of each dimension, outermost first
+    // numElements is only the first of these
+    std::vector<int> dimensions;
+
     void print() override;
 };
 
@@ -402,6 +475,9 @@ class ExternalArrayNode : public Node {
 
     int numElements;
 
+    // set by an INTERFACE m_axi pragma on the array
+    bool isAxi = false;
+    AxiInterface axiInterface;
 };
 
 class SubParameterArrayNode : public Node {
@@ -418,6 +494,26 @@ class SubParameterArrayNode : public Node {
     int numElements;
 };
 
+// One bank of a partitioned array, with --bank_nodes
+// accesses connect to the banks they reach instead of the whole array
+class MemoryBankNode : public Node {
+  public:
+    MemoryBankNode(Node *array, const std::string &variableName, std::vector<long> bank, int numElements)
+        : array(array), variableName(variableName), bank(bank), numElements(numElements) {}
+    Node *array;
+    std::string variableName;
+    // index of the bank in each partitioned dimension
+    std::vector<long> bank;
+
+    NodeVariant getVariant() override { return NodeVariant::MEMORY_BANK; }
+
+    void print() override;
+    TypeStruct getType() override { return array->getType(); }
+    TypeStruct getImmediateType() override { return array->getImmediateType(); }
+
+    int numElements;
+};
+
 //-----------------------------------------------
 //          Programl Proxy Nodes
 //-----------------------------------------------
@@ -445,6 +541,13 @@ class ArrayPartitionPragmaNode : public PragmaNode {
     }
 };
 
+class ArrayReshapePragmaNode : public PragmaNode {
+  public:
+    ArrayReshapePragmaNode(std::string reshapeStyle, int factor, int dim) : PragmaNode(factor) {
+        keyText = reshapeStyle + "ArrayReshape" + std::to_string(dim);
+    }
+};
+
 class Bram1P_ResourceAllocationPragmaNode : public PragmaNode {
   public:
     Bram1P_ResourceAllocationPragmaNode() { keyText = "resourceAllocation_bram1p"; }
@@ -1,5 +1,6 @@
 #include "nodePrinter.h"
 #include "args.h"
+#include "graphGenerator.h"
 #include "node.h"
 
 namespace {
@@ -22,6 +23,9 @@ std::string addPragmaToLabel(GNN::Node *node, std::string label) {
     if (node->partitionType2 != "none") {
         label += "\n Partition 2: " + node->partitionType2;
     }
+    if (node->reshapeType != "none") {
+        label += "\n Reshape: " + node->reshapeType + " " + std::to_string(node->reshapeFactor);
+    }
     if (node->inlined){
         label += "\n Inlined";
     }    
@@ -63,6 +67,10 @@ std::string typeToBitwidth(GNN::Node *node) {
     if (type.isVoid) {
         return "0";
     }
+    // narrowed by --range_bitwidth
+    if (node->rangeBitwidth > 0 && type.dataType == GNN::DataType::INTEGER && node->rangeBitwidth < type.bitwidth) {
+        return std::to_string(node->rangeBitwidth);
+    }
     return std::to_string(type.bitwidth);
 }
 
@@ -107,6 +115,36 @@ NodePrinter::NodePrinter(Node *node, const std::string &color) : color(color) {
     if (Nodes::graphGenerator->checkArg(ADD_FUNC_ID)) {
         attributes["funcID"] = std::to_string(node->functionID);
     }
+    if (Nodes::graphGenerator->checkArg(ADD_LOOP_ID)) {
+        attributes["loopID"] = std::to_string(node->loopID);
+        attributes["controlLoopID"] = std::to_string(Nodes::graphGenerator->getControlLoopID(node->loopID));
+    }
+    if (Nodes::graphGenerator->checkArg(ADD_DATAFLOW)) {
+        int stage = node->dataflowStage;
+        attributes["dataflowStage"] = std::to_string(stage);
+        attributes["dataflowRegion"] =
+            std::to_string(stage == -1 ? -1 : Nodes::graphGenerator->dataflowStages[stage].region);
+    }
+    if (Nodes::graphGenerator->checkArg(ADD_SCHEDULE)) {
+        attributes["asap"] = std::to_string(node->asap);
+        attributes["alap"] = std::to_string(node->alap);
+    }
+    if (Nodes::graphGenerator->checkArg(ADD_II)) {
+        attributes["ii"] = std::to_string(node->ii);
+        attributes["targetII"] = std::to_string(node->targetII);
+    }
+    if (Nodes::graphGenerator->checkArg(ADD_BANK_CONFLICTS)) {
+        attributes["bankConflicts"] = std::to_string(node->bankConflicts);
+        DerefNode *deref = dynamic_cast<DerefNode *>(node);
+        attributes["affineIndex"] = deref && deref->isAffine() ? "1" : "0";
+    }
+    if (Nodes::graphGenerator->checkArg(ADD_BURSTS)) {
+        attributes["reshape"] = node->reshapeType;
+        attributes["reshapeFactor"] = std::to_string(node->reshapeFactor);
+        attributes["sequentialRun"] = std::to_string(node->sequentialRun);
+        attributes["widenFactor"] = std::to_string(node->widenFactor);
+        attributes["burstLength"] = std::to_string(node->burstLength);
+    }
     if(Nodes::graphGenerator->checkArg(ADD_NUM_CALLS)){
         attributes["numCalls"] = std::to_string(Nodes::graphGenerator->getCallsNums(node->funcDec));
         attributes["numCallSites"] = std::to_string(Nodes::graphGenerator->getCallSiteNums(node->funcDec));
@@ -159,6 +197,12 @@ void NodePrinter::print() {
         attributes["label"] += "\n" + node->extraNote;
     }
 
+    Nodes::graphGenerator->addPrintedNode(node);
+
+    if (GraphRecorder *recorder = Nodes::graphGenerator->recorder) {
+        recorder->addNode(node->id, attributes);
+    }
+
     for (std::pair<std::string, std::string> attribute : attributes) {
         out += attribute.first;
         out += "=\"";
@@ -26,6 +26,13 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
 
     unrollFactor = 1;
     tripcount = 1;
+    tripcountPragmaFound = false;
+    pipelinePragmaFound = false;
+    dataflowPragmaFound = false;
+    flattenPragmaFound = false;
+    mergePragmaFound = false;
+    rewind = false;
+    loopTargetII = 0;
 
     for (SgNode *pragmaNode : pragmas) {
         // cast to SgPragma to get access to member variables
@@ -43,22 +50,57 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
         boost::algorithm::split(pragmaTextVector, pragmaText, boost::is_any_of(" ="));
         if (pragmaTextVectorUpper.size() > 1) {
             if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "INTERFACE") {
+                // the mode is either the first word or given by mode=
+                std::string mode = pragmaTextVectorUpper.size() > 2 ? pragmaTextVectorUpper[2] : "";
                 std::string variableName;
                 std::string bundle;
-                bool foundBundle = false;
+                std::string storageType;
+                AxiInterface axiInterface;
                 bool foundVariable = false;
                 for (int i = 2; i < pragmaTextVectorUpper.size() - 1; i++) {
-                    if (pragmaTextVectorUpper[i] == "PORT") {
+                    if (pragmaTextVectorUpper[i] == "MODE") {
+                        mode = pragmaTextVectorUpper[i + 1];
+                    } else if (pragmaTextVectorUpper[i] == "PORT") {
+                        foundVariable = true;
                         variableName = pragmaTextVector[i + 1];
-                    }
-                    if (pragmaTextVectorUpper[i] == "BUNDLE") {
+                    } else if (pragmaTextVectorUpper[i] == "BUNDLE") {
                         bundle = pragmaTextVector[i + 1];
+                    } else if (pragmaTextVectorUpper[i] == "STORAGE_TYPE") {
+                        storageType = pragmaTextVector[i + 1];
+                    } else if (pragmaTextVectorUpper[i] == "DEPTH" ||
+                               pragmaTextVectorUpper[i] == "MAX_READ_BURST_LENGTH" ||
+                               pragmaTextVectorUpper[i] == "MAX_WRITE_BURST_LENGTH" ||
+                               pragmaTextVectorUpper[i] == "MAX_WIDEN_BITWIDTH") {
+                        int value;
+                        try {
+                            value = std::stoi(pragmaTextVector[i + 1]);
+                        } catch (std::exception e) {
+                            throw std::runtime_error("Couldn't read " + pragmaTextVector[i] +
+                                                     " from interface pragma");
+                        }
+                        if (pragmaTextVectorUpper[i] == "DEPTH") {
+                            axiInterface.depth = value;
+                        } else if (pragmaTextVectorUpper[i] == "MAX_READ_BURST_LENGTH") {
+                            axiInterface.maxReadBurstLength = value;
+                        } else if (pragmaTextVectorUpper[i] == "MAX_WRITE_BURST_LENGTH") {
+                            axiInterface.maxWriteBurstLength = value;
+                        } else {
+                            axiInterface.maxWidenBitwidth = value;
+                        }
                     }
                 }
-                if (!foundBundle || !foundVariable) {
-                    throw std::runtime_error("Couldn't find variable or bundle on interface pragma");
+                if (!foundVariable) {
+                    throw std::runtime_error("Couldn't find port on interface pragma");
+                }
+
+                // the port type says how many ports the memory has
+                // a bundle is only a name, gmem2 is no more ports than gmem
+                variableToPortType[variableName] = storageType.empty() ? mode : storageType;
+
+                if (mode == "M_AXI") {
+                    axiInterface.bundle = bundle;
+                    graphGenerator->variableMapper->axiInterfaceMap[variableName] = axiInterface;
                 }
-                variableToPortType[variableName] = bundle;
             } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "UNROLL") {
                 for (int i = 2; i < pragmaTextVectorUpper.size() - 1; i++) {
                     if (pragmaTextVectorUpper[i] == "FACTOR") {
@@ -70,7 +112,31 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
                     }
                 }
             } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "PIPELINE") {
-                pipelined = true;
+                bool off = false;
+                for (int i = 2; i < pragmaTextVectorUpper.size(); i++) {
+                    if (pragmaTextVectorUpper[i] == "OFF") {
+                        off = true;
+                    } else if (pragmaTextVectorUpper[i] == "REWIND") {
+                        rewind = true;
+                    } else if (pragmaTextVectorUpper[i] == "II" && i + 1 < pragmaTextVectorUpper.size()) {
+                        try {
+                            loopTargetII = std::stoi(pragmaTextVector[i + 1]);
+                        } catch (std::exception e) {
+                            throw std::runtime_error("Couldn't read II from pipeline pragma");
+                        }
+                    }
+                }
+                if (!off) {
+                    pipelined = true;
+                    pipelinePragmaFound = true;
+                    targetII = loopTargetII;
+                }
+            } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "LOOP_FLATTEN") {
+                flattenPragmaFound = pragmaTextVectorUpper.size() < 3 || pragmaTextVectorUpper[2] != "OFF";
+            } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "LOOP_MERGE") {
+                mergePragmaFound = true;
+            } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "DATAFLOW") {
+                dataflowPragmaFound = true;
             } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "RESOURCE") {
                 std::string core;
                 std::string variable;
@@ -133,6 +199,44 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
                     throw std::runtime_error("Couldn't find one of type, variable, factor or dim on resource pragma");
                 }
                 graphGenerator->variableMapper->arrayPartitionMap[variable].push(std::make_tuple(type, factor, dim));
+            } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "ARRAY_RESHAPE") {
+                std::string type;
+                int factor;
+                int dim = 1;
+                std::string variable;
+                bool foundType = false;
+                bool foundVariable = false;
+                bool foundFactor = false;
+                for (int i = 2; i < pragmaTextVectorUpper.size() - 1; i++) {
+                    if (pragmaTextVectorUpper[i] == "TYPE") {
+                        foundType = true;
+                        type = pragmaTextVector[i + 1];
+                    } else if (pragmaTextVectorUpper[i] == "VARIABLE") {
+                        foundVariable = true;
+                        variable = pragmaTextVector[i + 1];
+                    } else if (pragmaTextVectorUpper[i] == "FACTOR") {
+                        try {
+                            foundFactor = true;
+                            factor = std::stoi(pragmaTextVector[i + 1]);
+                        } catch (std::exception e) {
+                            throw std::runtime_error("Couldn't read factor from array reshape pragma");
+                        }
+                    } else if (pragmaTextVectorUpper[i] == "DIM") {
+                        try {
+                            dim = std::stoi(pragmaTextVector[i + 1]);
+                        } catch (std::exception e) {
+                            throw std::runtime_error("Couldn't read dim from array reshape pragma");
+                        }
+                    }
+                }
+                // the tool reshapes the first dimension by default
+                if (!foundType || !foundVariable || (!foundFactor && type != "complete")) {
+                    throw std::runtime_error("Couldn't find one of type, variable or factor on array reshape pragma");
+                }
+                if (!foundFactor) {
+                    factor = 1;
+                }
+                graphGenerator->variableMapper->arrayReshapeMap[variable].push(std::make_tuple(type, factor, dim));
             } else if (pragmaTextVectorUpper[0] == "HLS" && pragmaTextVectorUpper[1] == "INLINE") {
                 if (pragmaTextVectorUpper[2] == "ON") {
                     functionInlined = true;
@@ -152,6 +256,7 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
                 if (!foundAvg) {
                     throw std::runtime_error("Couldn't find avg on tripcount pragma");
                 }
+                tripcountPragmaFound = true;
             }
         }
     }
@@ -167,6 +272,7 @@ void PragmaParser::parsePragmas(SgBasicBlock *bb) {
 
 void PragmaParser::stackPragmas() {
     pipelineStack.push(pipelined);
+    targetIIStack.push(targetII);
 }
 
 void PragmaParser::unstackPragmas() {
@@ -175,6 +281,8 @@ void PragmaParser::unstackPragmas() {
 
     pipelined = pipelineStack.top();
     pipelineStack.pop();
+    targetII = targetIIStack.top();
+    targetIIStack.pop();
 }
 
 void PragmaParser::enterLoopCondition() {
@@ -217,6 +325,24 @@ bool PragmaParser::getPreviouslyPipelined() {
 
 }
 
+int PragmaParser::getLoopUnrollFactor() { return unrollFactor; }
+
+float PragmaParser::getLoopTripcount() { return tripcountPragmaFound ? tripcount : 0; }
+
+bool PragmaParser::getLoopPipelined() { return pipelinePragmaFound; }
+
+bool PragmaParser::getDataflow() { return dataflowPragmaFound; }
+
+int PragmaParser::getLoopTargetII() { return loopTargetII; }
+
+bool PragmaParser::getLoopRewind() { return rewind; }
+
+bool PragmaParser::getLoopFlatten() { return flattenPragmaFound; }
+
+bool PragmaParser::getLoopMerge() { return mergePragmaFound; }
+
+int PragmaParser::getTargetII() { return targetII; }
+
 float PragmaParser::getPipelineTripcount(){
     return pipelineTripcount;
 }
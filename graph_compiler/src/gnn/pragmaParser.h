@@ -91,11 +91,24 @@ class PragmaParser {
     StackedFactor getUnrollFactor();
     bool getPipelined();
     bool getPreviouslyPipelined();
+    // the II requested by the pipeline pragma the nodes are in, 0 if it didn't give one
+    int getTargetII();
 
     float getPipelineTripcount();
 
     StackedFactor getTripcount();
 
+    // the pragmas found by the last call to parsePragmas,
+    // for recording the loop that bb is the body of
+    int getLoopUnrollFactor();
+    float getLoopTripcount();
+    bool getLoopPipelined();
+    bool getDataflow();
+    int getLoopTargetII();
+    bool getLoopRewind();
+    bool getLoopFlatten();
+    bool getLoopMerge();
+
     bool functionInlined = false;
     std::queue<SgFunctionDeclaration *> inlinedFunctions;
 
@@ -109,6 +122,14 @@ class PragmaParser {
     float tripcount = 1;
     int unrollFactor;
 
+    bool tripcountPragmaFound = false;
+    bool pipelinePragmaFound = false;
+    bool dataflowPragmaFound = false;
+    bool flattenPragmaFound = false;
+    bool mergePragmaFound = false;
+    bool rewind = false;
+    int loopTargetII = 0;
+
     bool pipelined = false;
     bool previouslyPipelined = false;
     float pipelineTripcount;
@@ -119,6 +140,9 @@ class PragmaParser {
 
 
     std::stack<bool> pipelineStack;
+
+    int targetII = 0;
+    std::stack<int> targetIIStack;
 };
 
 } // namespace GNN
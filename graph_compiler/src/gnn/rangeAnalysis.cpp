@@ -0,0 +1,374 @@
+#include "rangeAnalysis.h"
+#include "analysisUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using GNN::RangeAnalysis;
+
+// passes before ranges that are still growing are given up on
+const int WIDEN_AFTER = 8;
+
+RangeAnalysis::Range makeRange(double min, double max) {
+    RangeAnalysis::Range range;
+    range.known = true;
+    range.min = min;
+    range.max = max;
+    return range;
+}
+
+RangeAnalysis::Range join(RangeAnalysis::Range a, RangeAnalysis::Range b) {
+    if (!a.known || !b.known) {
+        return RangeAnalysis::Range();
+    }
+    return makeRange(std::min(a.min, b.min), std::max(a.max, b.max));
+}
+
+bool isSame(RangeAnalysis::Range a, RangeAnalysis::Range b) {
+    if (!a.known || !b.known) {
+        return a.known == b.known;
+    }
+    return a.min == b.min && a.max == b.max;
+}
+
+// the smallest and largest of some candidate bounds
+RangeAnalysis::Range hull(std::vector<double> values) {
+    return makeRange(*std::min_element(values.begin(), values.end()), *std::max_element(values.begin(), values.end()));
+}
+
+// fewest bits that hold a range, unsigned if it has no negative values
+int getBits(RangeAnalysis::Range range, bool &isUnsigned) {
+    isUnsigned = range.min >= 0;
+    for (int bits = 1; bits < 64; bits++) {
+        double lowest = isUnsigned ? 0 : -std::ldexp(1, bits - 1);
+        double highest = isUnsigned ? std::ldexp(1, bits) - 1 : std::ldexp(1, bits - 1) - 1;
+        if (range.min >= lowest && range.max <= highest) {
+            return bits;
+        }
+    }
+    return 64;
+}
+
+bool isShiftAmount(RangeAnalysis::Range range) { return range.known && range.min >= 0 && range.max < 64; }
+
+} // namespace
+
+namespace GNN {
+
+RangeAnalysis::RangeAnalysis(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    predecessors = Analysis::getDataflowPredecessors(graphGenerator);
+    memoryElements = Analysis::getMemoryElements(graphGenerator);
+
+    VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+    for (Edge *edge : graphGenerator->edges) {
+        if (dynamic_cast<WriteMemoryElementEdge *>(edge)) {
+            if (edge->destination->getVariant() == NodeVariant::LOCAL_SCALAR) {
+                writes[edge->destination].push_back(edge->source);
+            }
+        } else if (FunctionCallEdge *callEdge = dynamic_cast<FunctionCallEdge *>(edge)) {
+            for (SgExpression *parameter : callEdge->parameters) {
+                for (SgNode *node : NodeQuery::querySubTree(parameter, V_SgVarRefExp)) {
+                    SgInitializedName *varDec = isSgVarRefExp(node)->get_symbol()->get_declaration();
+                    SgInitializedName *underlyingVariable = variableMapper->getUnderlyingVariable(varDec);
+                    if (variableMapper->variableToReadNode.count(underlyingVariable)) {
+                        escaped.insert(variableMapper->variableToReadNode[underlyingVariable]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool RangeAnalysis::getRange(Node *node, Range &range) {
+    if (!node || !ranges.count(node)) {
+        return false;
+    }
+    range = ranges[node];
+    return true;
+}
+
+// C wraps integers that overflow, so a range that doesn't fit the node's type could be anything
+RangeAnalysis::Range RangeAnalysis::fitType(Node *node, Range range) {
+    if (!range.known) {
+        return range;
+    }
+    TypeStruct type;
+    try {
+        type = node->getType();
+    } catch (...) {
+        return Range();
+    }
+    if (type.isVoid || type.stringOverride || type.dataType != DataType::INTEGER) {
+        return Range();
+    }
+    if (type.bitwidth <= 0 || type.bitwidth >= 64) {
+        return range;
+    }
+
+    double lowest = type.isUnsigned ? 0 : -std::ldexp(1, type.bitwidth - 1);
+    double highest = type.isUnsigned ? std::ldexp(1, type.bitwidth) - 1 : std::ldexp(1, type.bitwidth - 1) - 1;
+    if (range.min < lowest || range.max > highest) {
+        return Range();
+    }
+    return range;
+}
+
+RangeAnalysis::Range RangeAnalysis::getArithmeticRange(const std::string &opType, Range lhs, Range rhs) {
+    if (!lhs.known || !rhs.known) {
+        return Range();
+    }
+
+    if (opType == "Addition") {
+        return makeRange(lhs.min + rhs.min, lhs.max + rhs.max);
+    } else if (opType == "Subtraction") {
+        return makeRange(lhs.min - rhs.max, lhs.max - rhs.min);
+    } else if (opType == "Multiplication") {
+        return hull({lhs.min * rhs.min, lhs.min * rhs.max, lhs.max * rhs.min, lhs.max * rhs.max});
+    } else if (opType == "Division") {
+        if (rhs.min <= 0 && rhs.max >= 0) {
+            return Range();
+        }
+        return hull({std::trunc(lhs.min / rhs.min), std::trunc(lhs.min / rhs.max), std::trunc(lhs.max / rhs.min),
+                     std::trunc(lhs.max / rhs.max)});
+    } else if (opType == "LeftShift" && isShiftAmount(rhs)) {
+        double low = std::ldexp(1, rhs.min);
+        double high = std::ldexp(1, rhs.max);
+        return hull({lhs.min * low, lhs.min * high, lhs.max * low, lhs.max * high});
+    } else if (opType == "RightShift" && isShiftAmount(rhs)) {
+        double low = std::ldexp(1, rhs.min);
+        double high = std::ldexp(1, rhs.max);
+        return hull({std::floor(lhs.min / low), std::floor(lhs.min / high), std::floor(lhs.max / low),
+                     std::floor(lhs.max / high)});
+    } else if (opType == "BitAnd") {
+        // anding with a non-negative value can't set bits it doesn't have
+        if (lhs.min >= 0 && rhs.min >= 0) {
+            return makeRange(0, std::min(lhs.max, rhs.max));
+        } else if (lhs.min >= 0) {
+            return makeRange(0, lhs.max);
+        } else if (rhs.min >= 0) {
+            return makeRange(0, rhs.max);
+        }
+    } else if (opType == "BitXor" || opType == "Xor" || opType == "Or") {
+        if (lhs.min >= 0 && rhs.min >= 0) {
+            bool isUnsigned;
+            int bits = getBits(makeRange(0, std::max(lhs.max, rhs.max)), isUnsigned);
+            return makeRange(0, std::ldexp(1, bits) - 1);
+        }
+    }
+    return Range();
+}
+
+// the offset into the bank the address lands in, assuming it's in bounds
+RangeAnalysis::Range RangeAnalysis::getAddressRange(DerefNode *deref) {
+    if (!deref->memoryElement) {
+        return Range();
+    }
+    std::vector<int> dimensions = Analysis::getArrayDimensions(deref->memoryElement);
+    double elements = 1;
+    for (int dimension : dimensions) {
+        elements *= dimension;
+    }
+    if (dimensions.empty() || elements < 1) {
+        return Range();
+    }
+    double depth = std::ceil(elements / Analysis::getNumBanks(deref->memoryElement));
+    Range offset = makeRange(0, depth - 1);
+
+    // a single index can't be further into its bank than it is into the array
+    std::vector<Node *> indices;
+    bool chained = false;
+    if (predecessors.count(deref)) {
+        for (Node *predecessor : predecessors[deref]) {
+            if (dynamic_cast<DerefNode *>(predecessor)) {
+                chained = true;
+            } else if (predecessor != deref->memoryElement) {
+                indices.push_back(predecessor);
+            }
+        }
+    }
+    Range index;
+    if (!chained && indices.size() == 1 && getRange(indices[0], index) && index.known && index.max >= 0) {
+        offset.max = std::min(offset.max, index.max);
+    }
+    return offset;
+}
+
+// false if the node's inputs haven't been reached yet
+bool RangeAnalysis::transfer(Node *node, Range &range) {
+    range = Range();
+
+    if (ConstantNode *constant = dynamic_cast<ConstantNode *>(node)) {
+        TypeStruct type = constant->getType();
+        if (!type.stringOverride && !type.isVoid && type.dataType == DataType::INTEGER && constant->canGetValue()) {
+            range = makeRange(constant->getValue(), constant->getValue());
+        }
+    } else if (LocalScalarNode *scalar = dynamic_cast<LocalScalarNode *>(node)) {
+        if (iteratorRanges.count(scalar)) {
+            range = iteratorRanges[scalar];
+        } else if (!escaped.count(scalar)) {
+            // writes that haven't been reached don't add anything yet
+            bool reached = false;
+            for (Node *write : writes[scalar]) {
+                Range writeRange;
+                if (getRange(write, writeRange)) {
+                    range = reached ? join(range, writeRange) : writeRange;
+                    reached = true;
+                }
+            }
+            return reached;
+        }
+    } else if (dynamic_cast<ReadNode *>(node)) {
+        if (memoryElements.count(node) && memoryElements[node]->getVariant() == NodeVariant::LOCAL_SCALAR) {
+            if (!getRange(memoryElements[node], range)) {
+                return false;
+            }
+            range = fitType(node, range);
+        }
+    } else if (WriteNode *write = dynamic_cast<WriteNode *>(node)) {
+        if (write->immediateInput) {
+            if (!getRange(write->immediateInput, range)) {
+                return false;
+            }
+            range = fitType(node, range);
+        }
+    } else if (ArithmeticNode *arithmetic = dynamic_cast<ArithmeticNode *>(node)) {
+        Range lhs, rhs;
+        if (arithmetic->arithmeticEdge) {
+            if (!getRange(arithmetic->arithmeticEdge->lhs, lhs) || !getRange(arithmetic->arithmeticEdge->rhs, rhs)) {
+                return false;
+            }
+            range = fitType(node, getArithmeticRange(arithmetic->opType, lhs, rhs));
+        }
+    } else if (SelectNode *select = dynamic_cast<SelectNode *>(node)) {
+        Range lhs, rhs;
+        if (!getRange(select->edge->lhs, lhs) || !getRange(select->edge->rhs, rhs)) {
+            return false;
+        }
+        range = fitType(node, join(lhs, rhs));
+    } else if (dynamic_cast<ComparisonNode *>(node)) {
+        range = makeRange(0, 1);
+    } else if (UnaryOpNode *unary = dynamic_cast<UnaryOpNode *>(node)) {
+        if (unary->opType == "Not") {
+            range = makeRange(0, 1);
+        }
+    } else if (DerefNode *deref = dynamic_cast<DerefNode *>(node)) {
+        range = getAddressRange(deref);
+    }
+    return true;
+}
+
+void RangeAnalysis::propagate() {
+    ranges.clear();
+    widened.clear();
+
+    bool changed = true;
+    for (int pass = 0; changed; pass++) {
+        changed = false;
+        for (Node *node : graphGenerator->nodes) {
+            Range range;
+            if (widened.count(node) || !transfer(node, range)) {
+                continue;
+            }
+            if (ranges.count(node) && isSame(ranges[node], range)) {
+                continue;
+            }
+            if (pass >= WIDEN_AFTER && ranges.count(node)) {
+                widened.insert(node);
+                range = Range();
+            }
+            ranges[node] = range;
+            changed = true;
+        }
+    }
+}
+
+void RangeAnalysis::annotate() {
+    int numNarrowed = 0;
+    double bitsSaved = 0;
+
+    for (Node *node : graphGenerator->nodes) {
+        Range range;
+        if (!getRange(node, range) || !range.known) {
+            continue;
+        }
+
+        // units work at a width that holds their operands as well as their result
+        ArithmeticUnitEdge *unitEdge = nullptr;
+        if (ArithmeticNode *arithmetic = dynamic_cast<ArithmeticNode *>(node)) {
+            unitEdge = arithmetic->arithmeticEdge;
+        } else if (SelectNode *select = dynamic_cast<SelectNode *>(node)) {
+            unitEdge = select->edge;
+        } else if (ComparisonNode *comparison = dynamic_cast<ComparisonNode *>(node)) {
+            unitEdge = comparison->edge;
+            if (!unitEdge) {
+                continue;
+            }
+            Range lhs, rhs;
+            if (!getRange(unitEdge->lhs, lhs) || !getRange(unitEdge->rhs, rhs)) {
+                continue;
+            }
+            range = join(lhs, rhs);
+            unitEdge = nullptr;
+        }
+        if (unitEdge) {
+            Range lhs, rhs;
+            if (!getRange(unitEdge->lhs, lhs) || !getRange(unitEdge->rhs, rhs)) {
+                continue;
+            }
+            range = join(range, join(lhs, rhs));
+        }
+        if (!range.known) {
+            continue;
+        }
+
+        TypeStruct type;
+        try {
+            type = node->getType();
+        } catch (...) {
+            continue;
+        }
+        if (type.isVoid || type.stringOverride || type.dataType != DataType::INTEGER) {
+            continue;
+        }
+
+        bool isUnsigned;
+        int bits = getBits(range, isUnsigned);
+        if (bits < type.bitwidth) {
+            numNarrowed++;
+            bitsSaved += type.bitwidth - bits;
+            node->rangeBitwidth = bits;
+            node->rangeUnsigned = isUnsigned;
+        }
+    }
+
+    graphGenerator->addStat("narrowedNodes", numNarrowed, false);
+    graphGenerator->addStat("narrowedBits", bitsSaved, false);
+}
+
+void RangeAnalysis::run() {
+    // iterators are first kept to their bounds, which is what they hold inside the loop,
+    // then widened by what their increments write, so the value they exit with fits too
+    for (LoopInfo &loop : graphGenerator->loops) {
+        LocalScalarNode *iterator = loop.iterator;
+        if (iterator && iterator->fixedSizeIterator && iterator->hasIteratorInit && iterator->writtenToAsIterator &&
+            !iterator->bounds.empty()) {
+            iteratorRanges[iterator] = hull(iterator->bounds);
+        }
+    }
+    propagate();
+
+    for (std::pair<LocalScalarNode *const, Range> &iterator : iteratorRanges) {
+        for (Node *write : writes[iterator.first]) {
+            Range writeRange;
+            if (getRange(write, writeRange)) {
+                iterator.second = join(iterator.second, writeRange);
+            }
+        }
+    }
+    propagate();
+
+    annotate();
+}
+
+} // namespace GNN
@@ -0,0 +1,64 @@
+#ifndef GNN_RANGE_ANALYSIS_H
+#define GNN_RANGE_ANALYSIS_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <set>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class LocalScalarNode;
+
+// Finds the interval of values every integer node can take, and sets its rangeBitwidth to the fewest bits that hold it.
+// Ranges start at constants and iterator bounds, and go through arithmetic, comparisons, selects,
+// the casts writes make and local scalars. Reads of anything else could be any value of their type.
+// An address gets the width of its offset into the bank its array is partitioned into.
+//
+// Variables written in a loop can feed back into themselves, so a range that is still growing
+// after a few passes is given up on. Iterators are the exception, their bounds are known.
+// Only runs with --range_bitwidth, sexts, printed bitwidths and the cost estimates use what it finds.
+class RangeAnalysis {
+  public:
+    RangeAnalysis(GraphGenerator *graphGenerator);
+
+    void run();
+
+    struct Range {
+        // false if the value could be anything its type holds
+        bool known = false;
+        double min = 0;
+        double max = 0;
+    };
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    std::map<Node *, std::vector<Node *>> predecessors;
+    std::map<Node *, Node *> memoryElements;
+    // the writes to each local scalar
+    std::map<Node *, std::vector<Node *>> writes;
+    // scalars passed to calls, which could write to them
+    std::set<Node *> escaped;
+
+    // a node without a range yet hasn't been reached, which is different to an unknown range
+    std::map<Node *, Range> ranges;
+    std::map<LocalScalarNode *, Range> iteratorRanges;
+    // nodes whose range kept growing, they stay unknown
+    std::set<Node *> widened;
+
+    bool getRange(Node *node, Range &range);
+    Range fitType(Node *node, Range range);
+    bool transfer(Node *node, Range &range);
+    Range getArithmeticRange(const std::string &opType, Range lhs, Range rhs);
+    Range getAddressRange(DerefNode *deref);
+    void propagate();
+    void annotate();
+};
+
+} // namespace GNN
+
+#endif
@@ -0,0 +1,213 @@
+#include "resourceEstimator.h"
+#include "analysisUtils.h"
+#include "edge.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// arrays at or below this many bits per bank are mapped to LUTRAM instead of BRAM
+const int LUTRAM_MAX_BITS = 1024;
+const int BRAM_BITS = 18432;
+const int BRAM_MAX_WIDTH = 36;
+// bits of distributed RAM per LUT
+const int LUTRAM_BITS_PER_LUT = 64;
+
+int log2Ceil(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) {
+        bits++;
+    }
+    return bits;
+}
+
+// DSP48 slices for an integer multiply of this width
+double multiplierDsps(int bitwidth) {
+    if (bitwidth <= 18) {
+        return 1;
+    } else if (bitwidth <= 32) {
+        return 3;
+    } else if (bitwidth <= 48) {
+        return 6;
+    }
+    return 10;
+}
+
+GNN::ResourceUsage usage(double lut, double ff, double dsp) {
+    GNN::ResourceUsage cost;
+    cost.lut = lut;
+    cost.ff = ff;
+    cost.dsp = dsp;
+    return cost;
+}
+
+// single and double precision costs of the floating point cores
+GNN::ResourceUsage floatCost(const std::string &opKind, bool isDouble) {
+    if (opKind == "Addition" || opKind == "Subtraction") {
+        return isDouble ? usage(445, 781, 3) : usage(205, 390, 2);
+    } else if (opKind == "Multiplication") {
+        return isDouble ? usage(299, 570, 11) : usage(143, 321, 3);
+    } else if (opKind == "Division") {
+        return isDouble ? usage(3211, 3070, 0) : usage(761, 1470, 0);
+    } else if (opKind == "Comparison") {
+        return isDouble ? usage(130, 66, 0) : usage(66, 34, 0);
+    } else if (opKind == "CastToFloat") {
+        return isDouble ? usage(412, 485, 0) : usage(340, 400, 0);
+    } else if (opKind == "FNeg" || opKind == "Select") {
+        return isDouble ? usage(64, 0, 0) : usage(32, 0, 0);
+    }
+    return usage(0, 0, 0);
+}
+
+} // namespace
+
+namespace GNN {
+
+void ResourceUsage::add(const ResourceUsage &other, double copies) {
+    lut += other.lut * copies;
+    ff += other.ff * copies;
+    dsp += other.dsp * copies;
+    bram += other.bram * copies;
+}
+
+ResourceUsage getOperationCost(const std::string &opKind, int bitwidth, bool isFloat, bool constantOperand) {
+    if (isFloat) {
+        return floatCost(opKind, bitwidth > 32);
+    }
+
+    if (opKind == "Addition" || opKind == "Subtraction") {
+        return usage(bitwidth, bitwidth, 0);
+    } else if (opKind == "Multiplication") {
+        // multiplying by a constant turns into shifts and adds
+        if (constantOperand) {
+            return usage(2 * bitwidth, bitwidth, 0);
+        }
+        return usage(bitwidth, 2 * bitwidth, multiplierDsps(bitwidth));
+    } else if (opKind == "Division") {
+        return usage(35 * bitwidth, 70 * bitwidth, 0);
+    } else if (opKind == "LeftShift" || opKind == "RightShift") {
+        // shifting by a constant is just wiring
+        if (constantOperand) {
+            return usage(0, 0, 0);
+        }
+        return usage(bitwidth * log2Ceil(bitwidth) / 2.0, 0, 0);
+    } else if (opKind == "Comparison") {
+        return usage(bitwidth / 2.0 + 1, 0, 0);
+    } else if (opKind == "BitAnd" || opKind == "BitXor" || opKind == "Or" || opKind == "Xor" ||
+               opKind == "Not" || opKind == "Select") {
+        return usage(bitwidth, 0, 0);
+    } else if (opKind == "CastToFloat") {
+        return floatCost(opKind, bitwidth > 32);
+    }
+    return usage(0, 0, 0);
+}
+
+ResourceUsage getArrayCost(Node *array) {
+    LocalArrayNode *localArray = dynamic_cast<LocalArrayNode *>(array);
+    ResourceUsage cost;
+    if (!localArray) {
+        return cost;
+    }
+
+    std::vector<int> dimensions = Analysis::getArrayDimensions(array);
+
+    double elements = 1;
+    for (int dim : dimensions) {
+        elements *= dim;
+    }
+    int bitwidth = Analysis::getBitwidth(array);
+    double banks = Analysis::getNumBanks(array);
+
+    double depth = std::ceil(elements / banks);
+    double bankBits = depth * bitwidth;
+
+    if (depth <= 1) {
+        // fully partitioned arrays are registers
+        cost.ff = banks * bankBits;
+    } else if (bankBits <= LUTRAM_MAX_BITS) {
+        cost.lut = banks * std::ceil(bankBits / LUTRAM_BITS_PER_LUT);
+    } else {
+        double widthBrams = std::ceil(double(bitwidth) / BRAM_MAX_WIDTH);
+        double sizeBrams = std::ceil(bankBits / BRAM_BITS);
+        cost.bram = banks * std::max(widthBrams, sizeBrams);
+    }
+    return cost;
+}
+
+void ResourceEstimator::run() {
+    total = ResourceUsage();
+    opCounts.clear();
+
+    addOperations();
+    addImplicitCasts();
+    addArrays();
+
+    for (std::pair<std::string, double> opCount : opCounts) {
+        graphGenerator->addStat("ops_" + opCount.first, opCount.second, false);
+    }
+    graphGenerator->addStat("estLUT", total.lut, true);
+    graphGenerator->addStat("estFF", total.ff, true);
+    graphGenerator->addStat("estDSP", total.dsp, true);
+    graphGenerator->addStat("estBRAM", total.bram, true);
+}
+
+void ResourceEstimator::addOperations() {
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        std::string opKind = Analysis::getOpKind(node.get());
+        if (opKind.empty()) {
+            continue;
+        }
+        double copies = Analysis::getReplication(node.get());
+        opCounts[opKind] += copies;
+
+        int bitwidth = Analysis::getBitwidth(node.get());
+        bool isFloat = Analysis::isFloat(node.get());
+        // comparisons are typed by their operands
+        if (ComparisonNode *comparison = dynamic_cast<ComparisonNode *>(node.get())) {
+            if (comparison->binaryComp) {
+                isFloat = Analysis::isFloat(comparison->lhs) || Analysis::isFloat(comparison->rhs);
+            }
+        }
+
+        ResourceUsage cost = getOperationCost(opKind, bitwidth, isFloat, Analysis::hasConstantOperand(node.get()));
+        total.add(cost, copies);
+    }
+}
+
+// int to float casts are only added to the graph when it's printed,
+// so find the edges that will add them
+void ResourceEstimator::addImplicitCasts() {
+    for (std::unique_ptr<Edge> &edge : graphGenerator->edges_unq) {
+        Node *castUser = nullptr;
+        int castWidth = 0;
+        if (ArithmeticUnitEdge *arithmeticEdge = dynamic_cast<ArithmeticUnitEdge *>(edge.get())) {
+            bool lhsFloat = Analysis::isFloat(arithmeticEdge->lhs);
+            bool rhsFloat = Analysis::isFloat(arithmeticEdge->rhs);
+            if (lhsFloat != rhsFloat) {
+                castUser = arithmeticEdge->unit;
+                castWidth = Analysis::getBitwidth(lhsFloat ? arithmeticEdge->lhs : arithmeticEdge->rhs);
+            }
+        } else if (ImplicitCastDataFlowEdge *castEdge = dynamic_cast<ImplicitCastDataFlowEdge *>(edge.get())) {
+            if (Analysis::isFloat(castEdge->typeDependency) && !Analysis::isFloat(castEdge->source)) {
+                castUser = castEdge->destination;
+                castWidth = Analysis::getBitwidth(castEdge->typeDependency);
+            }
+        }
+
+        if (castUser) {
+            double copies = Analysis::getReplication(castUser);
+            opCounts["CastToFloat"] += copies;
+            total.add(getOperationCost("CastToFloat", castWidth, true, false), copies);
+        }
+    }
+}
+
+void ResourceEstimator::addArrays() {
+    for (std::unique_ptr<Node> &node : graphGenerator->nodes_unq) {
+        if (node->getVariant() == NodeVariant::LOCAL_ARRAY) {
+            total.add(getArrayCost(node.get()), 1);
+        }
+    }
+}
+
+} // namespace GNN
@@ -0,0 +1,51 @@
+#ifndef GNN_RESOURCE_ESTIMATOR_H
+#define GNN_RESOURCE_ESTIMATOR_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include <map>
+#include <string>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+
+struct ResourceUsage {
+    double lut = 0;
+    double ff = 0;
+    double dsp = 0;
+    double bram = 0;
+
+    void add(const ResourceUsage &other, double copies);
+};
+
+// Estimates the LUT/FF/DSP/BRAM usage of a kernel straight from the graph,
+// using per operation costs scaled by bitwidth and replicated by unroll factor.
+// Rough, but cheap enough to throw out infeasible directive sets before inference.
+class ResourceEstimator {
+  public:
+    ResourceEstimator(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {}
+
+    void run();
+
+    ResourceUsage total;
+    std::map<std::string, double> opCounts;
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    void addOperations();
+    void addImplicitCasts();
+    void addArrays();
+};
+
+// cost of a single instance of an operation
+ResourceUsage getOperationCost(const std::string &opKind, int bitwidth, bool isFloat, bool constantOperand);
+
+// cost of storing a local array, given how it's partitioned
+ResourceUsage getArrayCost(Node *array);
+
+} // namespace GNN
+
+#endif
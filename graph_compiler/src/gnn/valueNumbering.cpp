@@ -0,0 +1,154 @@
+#include "valueNumbering.h"
+#include "args.h"
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <tuple>
+
+namespace GNN {
+
+ValueNumbering::ValueNumbering(GraphGenerator *graphGenerator) : graphGenerator(graphGenerator) {
+    enabled = graphGenerator->checkArg(VALUE_NUMBERING);
+}
+
+bool ValueNumbering::Key::operator<(const Key &other) const {
+    return std::tie(operation, operands) < std::tie(other.operation, other.operands);
+}
+
+ValueNumbering::Key ValueNumbering::makeKey(const std::string &operation, const std::vector<Node *> &operands,
+                                            bool commutative) {
+    Key key;
+    key.operation = operation;
+    for (Node *operand : operands) {
+        std::ostringstream out;
+        if (ConstantNode *constant = dynamic_cast<ConstantNode *>(operand)) {
+            out << "constant " << constant->value << " " << constant->getType().toString();
+        } else {
+            out << operand;
+        }
+        key.operands.push_back(out.str());
+    }
+    if (commutative) {
+        std::sort(key.operands.begin(), key.operands.end());
+    }
+    return key;
+}
+
+Node *ValueNumbering::find(const Key &key) {
+    if (!enabled || !table.values.count(key)) {
+        return nullptr;
+    }
+    numMerged++;
+    return table.values[key];
+}
+
+void ValueNumbering::insert(const Key &key, Node *node, const std::set<Node *> &dependencies) {
+    if (!enabled) {
+        return;
+    }
+    table.values[key] = node;
+    table.dependencies[key] = dependencies;
+    if (!table.scopes.empty()) {
+        table.scopes.back().push_back(key);
+    }
+}
+
+DerefNode *ValueNumbering::findDeref(SgBinaryOp *arrayIndex) {
+    return dynamic_cast<DerefNode *>(find(makeDerefKey(arrayIndex)));
+}
+
+void ValueNumbering::insertDeref(SgBinaryOp *arrayIndex, DerefNode *deref, const std::set<Node *> &indexVariables) {
+    insert(makeDerefKey(arrayIndex), deref, indexVariables);
+}
+
+// the same source text can address different arrays, through parameters of different inlined calls
+// or a shadowed variable, so the key has the nodes the variables resolve to instead of their names
+ValueNumbering::Key ValueNumbering::makeDerefKey(SgBinaryOp *arrayIndex) {
+    Key key;
+    key.operation = "Deref";
+    key.operands.push_back(describeExpression(arrayIndex));
+    return key;
+}
+
+std::string ValueNumbering::describeExpression(SgExpression *expr) {
+    if (SgVarRefExp *varRef = isSgVarRefExp(expr)) {
+        VariableMapper *variableMapper = graphGenerator->variableMapper.get();
+        SgInitializedName *variable = variableMapper->getUnderlyingVariable(varRef->get_symbol()->get_declaration());
+
+        // variables without a node, like struct fields, are told apart by their declaration
+        std::ostringstream out;
+        if (variableMapper->variableToReadNode.count(variable)) {
+            out << variableMapper->variableToReadNode[variable];
+        } else {
+            out << variable;
+        }
+        return out.str();
+    }
+    if (isSgValueExp(expr)) {
+        return expr->unparseToString();
+    }
+
+    std::string description = std::to_string(expr->variantT());
+    if (SgCastExp *cast = isSgCastExp(expr)) {
+        description += " " + cast->get_type()->unparseToString();
+    }
+    description += "(";
+    for (SgNode *child : expr->get_traversalSuccessorContainer()) {
+        if (SgExpression *operand = isSgExpression(child)) {
+            description += describeExpression(operand) + ",";
+        }
+    }
+    return description + ")";
+}
+
+void ValueNumbering::erase(const Key &key) {
+    table.values.erase(key);
+    table.dependencies.erase(key);
+}
+
+void ValueNumbering::invalidate(Node *variable) {
+    std::vector<Key> invalid;
+    for (std::pair<const Key, std::set<Node *>> &dependencies : table.dependencies) {
+        if (dependencies.second.count(variable)) {
+            invalid.push_back(dependencies.first);
+        }
+    }
+    for (Key &key : invalid) {
+        erase(key);
+    }
+}
+
+void ValueNumbering::invalidateReads() {
+    std::vector<Key> invalid;
+    for (std::pair<const Key, std::set<Node *>> &dependencies : table.dependencies) {
+        if (!dependencies.second.empty()) {
+            invalid.push_back(dependencies.first);
+        }
+    }
+    for (Key &key : invalid) {
+        erase(key);
+    }
+}
+
+void ValueNumbering::enterScope() { table.scopes.push_back(std::vector<Key>()); }
+
+void ValueNumbering::exitScope() {
+    assert(!table.scopes.empty());
+    for (Key &key : table.scopes.back()) {
+        erase(key);
+    }
+    table.scopes.pop_back();
+}
+
+void ValueNumbering::enterFunction() {
+    callers.push(table);
+    table = Table();
+}
+
+void ValueNumbering::exitFunction() {
+    assert(!callers.empty());
+    table = callers.top();
+    callers.pop();
+}
+
+} // namespace GNN
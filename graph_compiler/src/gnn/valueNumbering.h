@@ -0,0 +1,86 @@
+#ifndef GNN_VALUE_NUMBERING_H
+#define GNN_VALUE_NUMBERING_H
+
+#include "graphGenerator.h"
+#include "node.h"
+#include "rose.h"
+#include <map>
+#include <set>
+#include <stack>
+#include <string>
+#include <vector>
+
+namespace GNN {
+
+class GraphGenerator;
+class Node;
+class DerefNode;
+
+// Shares equivalent nodes across BBs as the graph is built, like GVN does in HLS tools.
+//
+// Values made in a branch or loop body are forgotten when it ends, since they don't dominate the code after it.
+// Reads and addresses are also forgotten when a variable they depend on is written,
+// and on entering a loop, since the loop body could write to anything before the next iteration.
+// Arithmetic only depends on its operand nodes, which can't change, so it is kept until its scope ends.
+//
+// Does nothing unless --value_numbering is set.
+class ValueNumbering {
+  public:
+    ValueNumbering(GraphGenerator *graphGenerator);
+
+    bool enabled = false;
+
+    // an operation and its operands, constants are compared by value and everything else by node
+    struct Key {
+        std::string operation;
+        std::vector<std::string> operands;
+
+        bool operator<(const Key &other) const;
+    };
+    Key makeKey(const std::string &operation, const std::vector<Node *> &operands, bool commutative = false);
+
+    // nullptr if there is no equivalent node
+    Node *find(const Key &key);
+    // dependencies are the variables and arrays the value reads
+    void insert(const Key &key, Node *node, const std::set<Node *> &dependencies = std::set<Node *>());
+
+    // addresses are found by the array and index variables they resolve to, so they depend on every variable in
+    // their index
+    DerefNode *findDeref(SgBinaryOp *arrayIndex);
+    void insertDeref(SgBinaryOp *arrayIndex, DerefNode *deref, const std::set<Node *> &indexVariables);
+
+    // drop values that depend on a variable or array that was written
+    void invalidate(Node *variable);
+    // drop everything that depends on a variable or array
+    void invalidateReads();
+
+    void enterScope();
+    void exitScope();
+
+    // functions that aren't inlined can't use their caller's values
+    void enterFunction();
+    void exitFunction();
+
+    int numMerged = 0;
+
+  private:
+    GraphGenerator *graphGenerator;
+
+    struct Table {
+        std::map<Key, Node *> values;
+        std::map<Key, std::set<Node *>> dependencies;
+        // the keys added in each open scope, innermost last
+        std::vector<std::vector<Key>> scopes;
+    };
+    Table table;
+    std::stack<Table> callers;
+
+    void erase(const Key &key);
+
+    Key makeDerefKey(SgBinaryOp *arrayIndex);
+    std::string describeExpression(SgExpression *expr);
+};
+
+} // namespace GNN
+
+#endif
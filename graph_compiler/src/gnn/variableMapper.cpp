@@ -1,6 +1,17 @@
 
 
 #include "variableMapper.h"
+#include "analysisUtils.h"
+#include "args.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// complete partitions of large arrays would make a node per element
+const int MAX_BANK_NODES = 64;
+
+} // namespace
 
 namespace GNN {
 
@@ -53,6 +64,98 @@ void VariableMapper::addArrayPragmas(const std::string &variableName, Node *poin
             new ArrayPartitionPragmaEdge(pragma, pointerNode);
         }
     }
+
+    // reshaping packs the elements of a dimension into wider words instead of more banks
+    if (arrayReshapeMap.count(variableName)) {
+        while (!arrayReshapeMap[variableName].empty()) {
+            std::tuple<std::string, int, int> reshapeData = arrayReshapeMap[variableName].front();
+            arrayReshapeMap[variableName].pop();
+
+            std::string type = std::get<0>(reshapeData);
+            int factor = std::get<1>(reshapeData);
+            int dim = std::get<2>(reshapeData);
+
+            if (type != "complete" && type != "cyclic" && type != "block") {
+                throw std::runtime_error("Unrecognized reshape type: " + type);
+            }
+            pointerNode->reshapeType = type;
+            pointerNode->reshapeFactor = factor;
+            pointerNode->reshapeDim = dim;
+
+            PragmaNode *pragma = new ArrayReshapePragmaNode(type, factor, dim);
+            new ArrayReshapePragmaEdge(pragma, pointerNode);
+        }
+    }
+
+    if (axiInterfaceMap.count(variableName)) {
+        if (ExternalArrayNode *externalArray = dynamic_cast<ExternalArrayNode *>(pointerNode)) {
+            externalArray->isAxi = true;
+            externalArray->axiInterface = axiInterfaceMap[variableName];
+            // a pointer's size is only known from the depth
+            if (externalArray->numElements <= 1 && externalArray->axiInterface.depth > 0) {
+                externalArray->numElements = externalArray->axiInterface.depth;
+            }
+        }
+    }
+
+    if (graphGenerator->checkArg(BANK_NODES) && graphGenerator->checkArg(ALLOCAS_TO_MEM_ELEMS)) {
+        addBankNodes(variableName, pointerNode);
+    }
+}
+
+void VariableMapper::addBankNodes(const std::string &variableName, Node *pointerNode) {
+    std::vector<int> dimensions = Analysis::getArrayDimensions(pointerNode);
+    std::string types[2] = {pointerNode->partitionType1, pointerNode->partitionType2};
+    int factors[2] = {pointerNode->partitionFactor1, pointerNode->partitionFactor2};
+
+    // the same banks getNumBanks counts, with each dimension cut down to what's left of the cap
+    std::vector<int> counts;
+    int numBanks = 1;
+    for (int i = 0; i < 2 && i < dimensions.size(); i++) {
+        int count = 1;
+        if (types[i] == "complete") {
+            count = dimensions[i];
+        } else if (factors[i] > 1) {
+            count = std::min(factors[i], dimensions[i]);
+        }
+        count = std::max(1, std::min(count, MAX_BANK_NODES / numBanks));
+        counts.push_back(count);
+        numBanks *= count;
+    }
+    if (numBanks <= 1) {
+        return;
+    }
+
+    int numElements = 1;
+    for (int dimension : dimensions) {
+        numElements *= dimension;
+    }
+    int bankElements = std::max(1, int(std::ceil(double(numElements) / numBanks)));
+
+    arrayBankCounts[pointerNode] = counts;
+    for (int i = 0; i < numBanks; i++) {
+        // the last partitioned dimension counts fastest
+        std::vector<long> bank(counts.size());
+        int rest = i;
+        for (int j = counts.size() - 1; j >= 0; j--) {
+            bank[j] = rest % counts[j];
+            rest /= counts[j];
+        }
+
+        Node *bankNode = new MemoryBankNode(pointerNode, variableName, bank, bankElements);
+        arrayBanks[pointerNode].push_back(bankNode);
+        new MemoryBankEdge(pointerNode, bankNode);
+    }
+}
+
+Node *VariableMapper::getBankNode(Node *array, std::vector<long> &bank) {
+    std::vector<int> &counts = arrayBankCounts[array];
+    int index = 0;
+    for (int i = 0; i < counts.size(); i++) {
+        long value = i < bank.size() ? bank[i] : 0;
+        index = index * counts[i] + ((value % counts[i]) + counts[i]) % counts[i];
+    }
+    return arrayBanks[array][index];
 }
 
 Node *VariableMapper::createLocalVariableNode(SgInitializedName *variable) {
@@ -67,6 +170,9 @@ Node *VariableMapper::createLocalVariableNode(SgInitializedName *variable) {
         SgArrayType *arrayType = isSgArrayType(variableType);
         assert(arrayType);
         node->numElements = arrayType->get_number_of_elements();
+        for (SgArrayType *dim = arrayType; dim; dim = isSgArrayType(dim->get_base_type())) {
+            node->dimensions.push_back(dim->get_number_of_elements());
+        }
         variableToReadNode[variable] = node;
         variableToWriteNode[variable] = node;
 
@@ -28,10 +28,19 @@ class VariableMapper {
     std::map<SgInitializedName *, Node *> variableToReadNode;
 
     std::set<Node *, Compare> nonReadVariables;
+
+    // const scalars whose value is known are read as a fresh constant, not through a variable
+    std::map<SgInitializedName *, std::pair<std::string, TypeStruct>> constantValues;
     std::map<SgInitializedName *, SgInitializedName *> underlyingVariableMap;
 
     std::map<std::string, std::string> resourceTypeMap;
     std::map<std::string, std::queue<std::tuple<std::string, int, int>>> arrayPartitionMap;
+    std::map<std::string, std::queue<std::tuple<std::string, int, int>>> arrayReshapeMap;
+    std::map<std::string, AxiInterface> axiInterfaceMap;
+
+    // the bank nodes of each partitioned array with --bank_nodes, and how many banks each partitioned dimension has
+    std::map<Node *, std::vector<Node *>> arrayBanks;
+    std::map<Node *, std::vector<int>> arrayBankCounts;
 
     std::map<SgType *, std::map<SgInitializedName *, StructFieldNode *>> structFieldMap;
 
@@ -47,6 +56,9 @@ class VariableMapper {
     SgInitializedName *getUnderlyingVariable(SgInitializedName *variable);
 
     void addArrayPragmas(const std::string &variableName, Node *pointerNode);
+    void addBankNodes(const std::string &variableName, Node *pointerNode);
+    // the node for a bank of each partitioned dimension, banks past the cap share a node
+    Node *getBankNode(Node *array, std::vector<long> &bank);
 
     void addStructTypeToMap(SgType *structType);
     StructFieldNode *getStructField(SgType *structType, SgInitializedName *variable);
@@ -1,13 +1,360 @@
 #include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <cerrno>
 #include <functional>
+#include <map>
 #include <numeric>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "commandLine.h"
 #include "utility.h"
 #include "gnn/args.h"
+#include "gnn/graphCoarsener.h"
 #include "gnn/graphGenerator.h"
+#include "gnn/loopTree.h"
 #include "rose.h"
 
+namespace {
+
+// insert a graph's suffix before the extension of a file name
+std::string addSuffix(const std::string &fileName, const std::string &suffix) {
+    size_t extension = fileName.find_last_of('.');
+    if (extension == std::string::npos || fileName.find('/', extension) != std::string::npos) {
+        return fileName + suffix;
+    }
+    return fileName.substr(0, extension) + suffix + fileName.substr(extension);
+}
+
+// the command line without a switch and its value
+std::vector<std::string> removeSwitch(const std::vector<std::string> &args, const std::string &name) {
+    std::vector<std::string> kept;
+    for (int i = 0; i < args.size(); i++) {
+        if (args[i] == "--" + name) {
+            i++;
+        } else if (args[i].rfind("--" + name + "=", 0) != 0) {
+            kept.push_back(args[i]);
+        }
+    }
+    return kept;
+}
+
+// one graph to make: a top level function, with the switches of one view
+struct Job {
+    Sawyer::CommandLine::ParserResult parserResult;
+    SgFunctionDefinition *topLevelFunctionDef;
+    // written to outputs/<name>.dot
+    std::string name;
+    // added to the loop tree file name and shown above the stats, empty if this is the only graph
+    std::string suffix;
+    // set by the server, every graph and its stats are sent back on stdout instead
+    bool toClient = false;
+};
+
+// generate, print and save one graph
+void emitGraph(Job &job) {
+    Sawyer::CommandLine::ParserResult &parserResult = job.parserResult;
+    SgFunctionDefinition *topLevelFunctionDef = job.topLevelFunctionDef;
+
+    bool makePdf = parserResult.have(GNN::MAKE_PDF);
+    bool makeDot = parserResult.have(GNN::MAKE_DOT);
+    bool printStats = parserResult.have(GNN::STATS);
+    bool printLoopTree = parserResult.have(GNN::LOOP_TREE);
+
+    GNN::GraphGenerator graphGen = GNN::GraphGenerator(parserResult);
+    graphGen.generateGraph(topLevelFunctionDef);
+
+    std::ostringstream graphOut;
+    std::streambuf *coutbuf = std::cout.rdbuf(graphOut.rdbuf());
+    if (parserResult.have(GNN::COARSEN)) {
+        GNN::GraphCoarsener(&graphGen, parserResult.parsed(GNN::COARSEN).back().asString()).print();
+    } else {
+        graphGen.printGraph();
+    }
+    std::cout.rdbuf(coutbuf);
+    std::string graph = graphOut.str();
+
+    std::string stats;
+    if (printStats) {
+        std::ostringstream statsOut;
+        std::streambuf *cerrbuf = std::cerr.rdbuf(statsOut.rdbuf());
+        graphGen.printStats();
+        std::cerr.rdbuf(cerrbuf);
+        stats = statsOut.str();
+    }
+
+    std::string loopTree;
+    if (printLoopTree) {
+        std::ostringstream loopTreeOut;
+        GNN::printLoopTree(&graphGen, loopTreeOut);
+        loopTree = loopTreeOut.str();
+    }
+
+    if (job.toClient) {
+        // each graph is named in a comment before it, and its stats follow as comments, so the reply is still dot
+        std::cout << "// graph " << job.name << "\n" << graph;
+        if (printStats) {
+            std::istringstream statLines(stats);
+            std::string line;
+            while (std::getline(statLines, line)) {
+                std::cout << "// " << line << "\n";
+            }
+        }
+        // several graphs can't share stdout, so each goes to its own file
+    } else if (makePdf || makeDot || !job.suffix.empty()) {
+        std::string fileName = "outputs/" + job.name;
+
+        std::ofstream out(fileName + ".dot");
+        out << graph;
+        out.close();
+
+        if (makePdf) {
+            std::string reorderCall =
+                "python scripts/reorderNodes.py " + fileName + ".dot " + fileName + "_reordered.dot";
+            system(reorderCall.c_str());
+
+            std::string dotCall = "dot -Tpdf " + fileName + "_reordered.dot -o " + fileName + ".pdf";
+            system(dotCall.c_str());
+        }
+    } else {
+        std::cout << graph;
+    }
+
+    if (printStats && !job.toClient) {
+        if (!job.suffix.empty()) {
+            stats = "Graph " + job.suffix.substr(1) + ":\n" + stats;
+        }
+        std::cerr << stats;
+    }
+
+    if (printLoopTree) {
+        std::ofstream loopTreeFile(addSuffix(parserResult.parsed(GNN::LOOP_TREE).back().asString(), job.suffix));
+        loopTreeFile << loopTree;
+    }
+}
+
+// a graph's process has finished, false if it failed or crashed
+bool waitForJob(std::map<pid_t, std::string> &running) {
+    int status = 0;
+    pid_t pid = wait(&status);
+    while (pid < 0 && errno == EINTR) {
+        pid = wait(&status);
+    }
+    if (pid < 0) {
+        // nothing left to wait for, so whatever was running can't be accounted for
+        for (std::pair<const pid_t, std::string> &job : running) {
+            std::cerr << "Lost track of graph " << job.second << std::endl;
+        }
+        running.clear();
+        return false;
+    }
+    std::string name = running[pid];
+    running.erase(pid);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        return true;
+    }
+    std::cerr << "Failed to make graph " << name << std::endl;
+    return false;
+}
+
+// make one graph, reporting rather than passing on anything it throws
+bool tryEmitGraph(Job &job) {
+    try {
+        emitGraph(job);
+    } catch (std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// make each graph in a process of its own, up to maxJobs at once
+// the graph generator keeps state in statics, so graphs can't be made side by side in one process,
+// but forked after the parse every process starts with the AST already built
+bool runJobs(std::vector<Job> &jobs, int maxJobs) {
+    bool succeeded = true;
+    std::map<pid_t, std::string> running;
+    for (Job &job : jobs) {
+        if (running.size() == maxJobs) {
+            succeeded &= waitForJob(running);
+        }
+
+        // anything still buffered would be written again by the child
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            int status = tryEmitGraph(job) ? 0 : 1;
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(status);
+        } else if (pid < 0) {
+            // can't fork, so make it here
+            if (!tryEmitGraph(job)) {
+                std::cerr << "Failed to make graph " << job.name << std::endl;
+                succeeded = false;
+            }
+        } else {
+            running[pid] = job.name;
+        }
+    }
+    while (!running.empty()) {
+        succeeded &= waitForJob(running);
+    }
+    return succeeded;
+}
+
+// the graphs a command line asks for: every view of every top level function, all from the same AST
+std::vector<Job> makeJobs(Sawyer::CommandLine::ParserResult &parserResult, const std::vector<std::string> &args,
+                          SgProject *project) {
+    std::vector<std::string> topLevelFunctionNames = AIR::CommandLine::getTopLevelFunctionNames(parserResult);
+    std::vector<SgFunctionDefinition *> topLevelFunctionDefs =
+        AIR::getTopLevelFunctionDefs(project, topLevelFunctionNames);
+    std::vector<std::pair<std::string, std::vector<std::string>>> views = AIR::CommandLine::getViews(parserResult);
+
+    // every view is made with the switches it adds
+    std::vector<std::string> baseArgs = removeSwitch(args, GNN::VIEW);
+    std::vector<Sawyer::CommandLine::ParserResult> viewResults;
+    for (std::pair<std::string, std::vector<std::string>> &view : views) {
+        std::vector<std::string> viewArgs = baseArgs;
+        viewArgs.insert(viewArgs.end(), view.second.begin(), view.second.end());
+        viewResults.push_back(AIR::CommandLine::parseCommandLine(viewArgs));
+    }
+
+    bool severalTops = topLevelFunctionDefs.size() > 1;
+    std::vector<Job> jobs;
+    for (SgFunctionDefinition *topLevelFunctionDef : topLevelFunctionDefs) {
+        std::string topLevelFunctionName = topLevelFunctionDef->get_declaration()->get_name();
+        std::string suffix = severalTops ? "_" + topLevelFunctionName : "";
+
+        if (views.empty()) {
+            jobs.push_back({parserResult, topLevelFunctionDef, topLevelFunctionName, suffix});
+        }
+        for (int i = 0; i < views.size(); i++) {
+            jobs.push_back({viewResults[i], topLevelFunctionDef, topLevelFunctionName + "_" + views[i].first,
+                            suffix + "_" + views[i].first});
+        }
+    }
+    return jobs;
+}
+
+// one request to the server, in a worker forked from it
+// the request is a line of switches added to the server's own, every graph it makes is sent back
+void handleRequest(int connection, const std::vector<std::string> &serverArgs, SgProject *project) {
+    std::string request;
+    char c;
+    while (read(connection, &c, 1) == 1 && c != '\n') {
+        request += c;
+    }
+
+    std::vector<std::string> args = serverArgs;
+    boost::algorithm::trim(request);
+    if (!request.empty()) {
+        std::vector<std::string> words;
+        boost::algorithm::split(words, request, boost::is_any_of(" "), boost::token_compress_on);
+        args.insert(args.end(), words.begin(), words.end());
+    }
+
+    dup2(connection, STDOUT_FILENO);
+    close(connection);
+
+    Sawyer::CommandLine::ParserResult parserResult = AIR::CommandLine::parseCommandLine(args);
+    std::vector<Job> jobs = makeJobs(parserResult, args, project);
+    for (Job &job : jobs) {
+        job.toClient = true;
+        emitGraph(job);
+    }
+}
+
+// a worker has finished, tell its client how it went
+// the status is a dot comment, so a graph followed by it can still be read as dot
+void finishRequest(std::map<pid_t, int> &workers, pid_t pid, int status) {
+    int connection = workers[pid];
+    workers.erase(pid);
+
+    std::string result = WIFEXITED(status) ? "exit " + std::to_string(WEXITSTATUS(status))
+                                           : "signal " + std::to_string(WTERMSIG(status));
+    std::string message = "// " + result + "\n";
+    send(connection, message.c_str(), message.size(), MSG_NOSIGNAL);
+    close(connection);
+    if (result != "exit 0") {
+        std::cerr << "Worker " << pid << " failed with " << result << std::endl;
+    }
+}
+
+// keep the parsed AST in this process and fork a worker from it for each request on the socket
+// each graph only pays for its own walk, and a worker that crashes takes nothing else down
+int serve(const std::string &socketPath, const std::vector<std::string> &serverArgs, SgProject *project,
+          int maxWorkers) {
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (server < 0 || socketPath.size() >= sizeof(address.sun_path)) {
+        std::cout << "Couldn't open socket " << socketPath << std::endl;
+        return 1;
+    }
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    unlink(socketPath.c_str());
+    if (bind(server, (sockaddr *)&address, sizeof(address)) < 0 || listen(server, SOMAXCONN) < 0) {
+        std::cout << "Couldn't listen on socket " << socketPath << std::endl;
+        return 1;
+    }
+    std::cerr << "Serving on " << socketPath << std::endl;
+
+    std::map<pid_t, int> workers;
+    while (true) {
+        int status;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, workers.size() < maxWorkers ? WNOHANG : 0)) > 0) {
+            finishRequest(workers, pid, status);
+        }
+
+        // wake up now and then to collect workers even if no requests come
+        pollfd waiting = {server, POLLIN, 0};
+        if (poll(&waiting, 1, 100) <= 0) {
+            continue;
+        }
+        int connection = accept(server, NULL, NULL);
+        if (connection < 0) {
+            continue;
+        }
+
+        // anything still buffered would be written again by the worker
+        std::cout.flush();
+        std::cerr.flush();
+        pid = fork();
+        if (pid == 0) {
+            // the client only sees the end of its reply once every copy of its connection is closed
+            close(server);
+            for (std::pair<const pid_t, int> &worker : workers) {
+                close(worker.second);
+            }
+            int workerStatus = 0;
+            try {
+                handleRequest(connection, serverArgs, project);
+            } catch (std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                workerStatus = 1;
+            }
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(workerStatus);
+        } else if (pid < 0) {
+            std::string message = "// fork failed\n";
+            send(connection, message.c_str(), message.size(), MSG_NOSIGNAL);
+            close(connection);
+        } else {
+            workers[pid] = connection;
+        }
+    }
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
     // Initialize and check compatibility. See Rose::initialize
     ROSE_INITIALIZE;
@@ -15,10 +362,10 @@ int main(int argc, char *argv[]) {
     Sawyer::CommandLine::ParserResult parserResult = AIR::CommandLine::parseCommandLine(argc, argv);
 
     std::vector<std::string> frontendArgs;
-    std::string topLevelFunctionName;
+    std::vector<std::string> args(argv, argv + argc);
+    std::vector<Job> jobs;
 
     SgProject *project;
-    SgFunctionDefinition *topLevelFunctionDef;
 
     try {
         frontendArgs = AIR::CommandLine::getFrontendArgs(parserResult);
@@ -30,40 +377,30 @@ int main(int argc, char *argv[]) {
         SgGlobal *globalScope = SageInterface::getFirstGlobalScope(project);
         SageBuilder::pushScopeStack(isSgScopeStatement(globalScope));
 
-        topLevelFunctionName = AIR::CommandLine::getTopLevelFunctionName(parserResult);
-        topLevelFunctionDef = AIR::getTopLevelFunctionDef(project, topLevelFunctionName);
+        // the graphs are asked for later, by the server's clients
+        if (!parserResult.have(GNN::SERVE)) {
+            jobs = makeJobs(parserResult, args, project);
+        }
     } catch (std::invalid_argument e) {
         std::cout << e.what() << std::endl;
         return 1;
     }
 
-    bool makePdf = parserResult.have(GNN::MAKE_PDF);
-    bool makeDot = parserResult.have(GNN::MAKE_DOT);
-
-    GNN::GraphGenerator graphGen = GNN::GraphGenerator(parserResult);
-    graphGen.generateGraph(topLevelFunctionDef);
-
-    if (makePdf || makeDot) {
-        std::string fileName = "outputs/" + topLevelFunctionName;
-
-        std::ofstream out(fileName + ".dot");
-        std::streambuf *coutbuf = std::cout.rdbuf(); // save old buf
-        std::cout.rdbuf(out.rdbuf());                // redirect std::cout
-
-        graphGen.printGraph();
-
-        std::cout.rdbuf(coutbuf); // restore cour
-
-        if (makePdf) {
-            std::string reorderCall =
-                "python scripts/reorderNodes.py " + fileName + ".dot " + fileName + "_reordered.dot";
-            system(reorderCall.c_str());
-
-            std::string dotCall = "dot -Tpdf " + fileName + "_reordered.dot -o " + fileName + ".pdf";
-            system(dotCall.c_str());
+    int maxJobs = parserResult.have(GNN::JOBS) ? parserResult.parsed(GNN::JOBS).back().asInt() : 1;
+    if (parserResult.have(GNN::SERVE)) {
+        // a server handles a request per core unless told otherwise
+        if (!parserResult.have(GNN::JOBS)) {
+            maxJobs = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
         }
-    } else {
-        graphGen.printGraph();
+        return serve(parserResult.parsed(GNN::SERVE).back().asString(), removeSwitch(args, GNN::SERVE), project,
+                     maxJobs);
+    }
+
+    if (maxJobs > 1 && jobs.size() > 1) {
+        return runJobs(jobs, maxJobs) ? 0 : 1;
+    }
+    for (Job &job : jobs) {
+        emitGraph(job);
     }
 
     return 0;
@@ -3,6 +3,7 @@
 #include "unordered_set"
 
 #include <boost/algorithm/string.hpp>
+#include <fnmatch.h>
 
 
 namespace AIR {
@@ -99,6 +100,40 @@ SgFunctionDefinition *getTopLevelFunctionDef(SgProject *project, std::string top
     return topLevelFunctionDef;
 }
 
+// Find the definitions of every top level function specified by the CLI argument
+// Names are looked up as before, glob patterns match every function defined in the project
+std::vector<SgFunctionDefinition *> getTopLevelFunctionDefs(SgProject *project, std::vector<std::string> patterns) {
+    std::vector<SgFunctionDefinition *> topLevelFunctionDefs;
+    std::unordered_set<std::string> found;
+
+    for (std::string &pattern : patterns) {
+        if (pattern.find_first_of("*?[") == std::string::npos) {
+            if (found.insert(pattern).second) {
+                topLevelFunctionDefs.push_back(getTopLevelFunctionDef(project, pattern));
+            }
+            continue;
+        }
+
+        bool matched = false;
+        for (SgNode *node : NodeQuery::querySubTree(project, V_SgFunctionDefinition)) {
+            SgFunctionDefinition *functionDef = isSgFunctionDefinition(node);
+            std::string functionName = functionDef->get_declaration()->get_name();
+            if (fnmatch(pattern.c_str(), functionName.c_str(), 0) != 0) {
+                continue;
+            }
+            matched = true;
+            if (found.insert(functionName).second) {
+                topLevelFunctionDefs.push_back(functionDef);
+            }
+        }
+        if (!matched) {
+            throw std::invalid_argument("No function matching \"" + pattern + "\" was found.");
+        }
+    }
+
+    return topLevelFunctionDefs;
+}
+
 // Get all the references to a variable inside a function call
 std::vector<SgVarRefExp *> findVariableReferences(SgFunctionCallExp *functionCall, SgInitializedName *parameter) {
 
@@ -8,6 +8,7 @@ namespace AIR {
 
 
 SgFunctionDefinition *getTopLevelFunctionDef(SgProject *project, std::string topLevelFunctionName);
+std::vector<SgFunctionDefinition *> getTopLevelFunctionDefs(SgProject *project, std::vector<std::string> patterns);
 
 SgFunctionDeclaration *getFuncDecFromCall(SgFunctionCallExp *functionCall);
 bool expressionAccessesVariable(SgExpression *expression, SgInitializedName *variable);